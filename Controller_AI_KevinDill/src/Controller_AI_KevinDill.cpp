@@ -22,15 +22,10 @@
 
 #include "Controller_AI_KevinDill.h"
 
-#include "Constants.h"
 #include "EntityStats.h"
 #include "iPlayer.h"
 #include "Vec2.h"
 
-static const Vec2 ksGiantPos(LEFT_BRIDGE_CENTER_X, RIVER_TOP_Y - 0.5f);
-static const Vec2 ksRoguePos(LEFT_BRIDGE_CENTER_X, RIVER_TOP_Y - 1.5f);
-static const Vec2 ksArcherPos(LEFT_BRIDGE_CENTER_X, 0.f);
-
 void Controller_AI_KevinDill::tick(float deltaTSec)
 {
     assert(m_pPlayer);
@@ -38,11 +33,18 @@ void Controller_AI_KevinDill::tick(float deltaTSec)
     // wait for elixir
     if (m_pPlayer->getElixir() >= 9)
     {
-        // convert the positions from player space to game space
+        // work out the positions in player space (by the left bridge), then
+        // convert them to game space
+        const ArenaLayout& layout = m_pPlayer->getLayout();
+        const float bridgeX = layout.getBridgeCenterX(true);
+        const Vec2 giantPos(bridgeX, layout.getRiverTopY() - 0.5f);
+        const Vec2 roguePos(bridgeX, layout.getRiverTopY() - 1.5f);
+        const Vec2 archerPos(bridgeX, 0.5f);      // the middle of the back row
+
         bool isNorth = m_pPlayer->isNorth();
-        Vec2 giantPos_Game = ksGiantPos.Player2Game(isNorth);
-        Vec2 archerPos_Game = ksArcherPos.Player2Game(isNorth);
-        Vec2 roguePos_Game = ksRoguePos.Player2Game(isNorth);
+        Vec2 giantPos_Game = layout.playerToGame(giantPos, isNorth);
+        Vec2 archerPos_Game = layout.playerToGame(archerPos, isNorth);
+        Vec2 roguePos_Game = layout.playerToGame(roguePos, isNorth);
 
         // Create two archers and a giant
         m_pPlayer->placeMob(iEntityStats::Giant, giantPos_Game);
@@ -0,0 +1,500 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Controller_AI_MCTS.h"
+
+#include "iPlayer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <thread>
+
+// How finely the model steps.  Much coarser than the Game, which is most 
+// of why a playout is cheap.
+static const float ksStepSec = 0.25f;
+
+// How long "wait" waits for, and the longest we'll wait to afford a mob.
+static const float ksWaitSec = 1.f;
+static const float ksMaxSaveSec = 10.f;
+
+// Past this many of our decisions, playouts are random.
+static const int ksMaxDepth = 4;
+
+// The exploration constant for UCT.  Values are between 0 and 1.
+static const float ksExploration = 0.7f;
+
+Controller_AI_MCTS::Settings::Settings()
+    : m_DecisionBudgetMs(5.f)
+    , m_NumThreads(1)
+    , m_DecisionIntervalSec(0.5f)
+    , m_HorizonSec(20.f)
+    , m_Seed(12345)
+{
+}
+
+// One search tree.  The nodes are kept in a vector that's allocated up 
+// front, and reused from one decision to the next.  Each node is a sequence
+// of our actions from the root - we don't store the states, we replay the
+// actions to get back to them.
+class Controller_AI_MCTS::Searcher
+{
+public:
+    static const uint32_t ksMaxNodes = 1 << 15;
+
+    explicit Searcher(unsigned int seed)
+        : m_Rng(seed ? seed : 1)
+        , m_NumPlayouts(0)
+        , m_OpponentThreshold(0.f)
+        , m_OurThreshold(0.f)
+    {
+        m_Nodes.reserve(ksMaxNodes);
+    }
+
+    // Throws away the old tree, to start on a new decision.
+    void reset(bool bNorth, const std::vector<Action>* pActions, const Settings& settings)
+    {
+        m_pActions = pActions;
+        m_bNorth = bNorth;
+        m_HorizonSec = settings.m_HorizonSec;
+        m_NumPlayouts = 0;
+
+        m_Nodes.clear();
+        m_Nodes.push_back(Node());
+        expand(0);
+    }
+
+    // Grows the tree until the deadline.
+    void run(const ForwardModel& root, std::chrono::steady_clock::time_point deadline)
+    {
+        // Always do at least one playout per option, however short the 
+        // budget.
+        while ((m_NumPlayouts < m_Nodes[0].m_NumChildren) || (std::chrono::steady_clock::now() < deadline))
+        {
+            playout(root);
+        }
+    }
+
+    unsigned long long getNumPlayouts() const { return m_NumPlayouts; }
+
+    // How many times we tried each of our options at the root.
+    void addRootVisits(std::vector<unsigned long long>& visits) const
+    {
+        const Node& root = m_Nodes[0];
+        for (uint32_t i = 0; i < root.m_NumChildren; ++i)
+        {
+            visits[i] += m_Nodes[root.m_FirstChild + i].m_Visits;
+        }
+    }
+
+private:
+    struct Node
+    {
+        uint32_t m_FirstChild;
+        uint32_t m_NumChildren;
+        uint32_t m_Visits;
+        float m_TotalValue;
+
+        Node() : m_FirstChild(0), m_NumChildren(0), m_Visits(0), m_TotalValue(0.f) {}
+    };
+
+    // xorshift32.  Each searcher has its own, so threads don't share.
+    uint32_t random()
+    {
+        m_Rng ^= m_Rng << 13;
+        m_Rng ^= m_Rng >> 17;
+        m_Rng ^= m_Rng << 5;
+        return m_Rng;
+    }
+
+    float randomFloat(float lo, float hi) { return lo + (hi - lo) * (float)(random() >> 8) / (float)(1 << 24); }
+
+    bool expand(uint32_t node)
+    {
+        const uint32_t numChildren = (uint32_t)m_pActions[0].size();
+        if (m_Nodes.size() + numChildren > ksMaxNodes)
+            return false;
+
+        m_Nodes[node].m_FirstChild = (uint32_t)m_Nodes.size();
+        m_Nodes[node].m_NumChildren = numChildren;
+        m_Nodes.resize(m_Nodes.size() + numChildren);
+        return true;
+    }
+
+    uint32_t select(uint32_t node)
+    {
+        const Node& parent = m_Nodes[node];
+        const float logVisits = logf((float)std::max(parent.m_Visits, 1u));
+        uint32_t best = parent.m_FirstChild;
+        float bestScore = -1.f;
+        for (uint32_t i = parent.m_FirstChild; i < parent.m_FirstChild + parent.m_NumChildren; ++i)
+        {
+            const Node& child = m_Nodes[i];
+            if (child.m_Visits == 0)
+                return i;
+
+            const float score = child.m_TotalValue / (float)child.m_Visits + 
+                                ksExploration * sqrtf(logVisits / (float)child.m_Visits);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // A random player: save up to a random amount of elixir, then place a 
+    // random mob at a random spot.
+    void playRandomly(bool bOurs)
+    {
+        const bool bNorth = bOurs ? m_bNorth : !m_bNorth;
+        float& threshold = bOurs ? m_OurThreshold : m_OpponentThreshold;
+        if (m_State.getElixir(bNorth) < threshold)
+            return;
+
+        const std::vector<Action>& actions = m_pActions[bOurs ? 0 : 1];
+        const Action& action = actions[random() % actions.size()];
+        if ((action.m_Type != iEntityStats::InvalidMobType) && m_State.canPlace(bNorth, action.m_Type))
+        {
+            m_State.place(bNorth, action.m_Type, action.m_X, action.m_Y);
+            threshold = randomFloat(2.f, 9.f);
+        }
+    }
+
+    void advance(float sec)
+    {
+        const float endTime = m_State.getTime() + sec;
+        while ((m_State.getTime() < endTime) && !isOver())
+        {
+            playRandomly(false);
+            m_State.step(ksStepSec);
+        }
+    }
+
+    // Our move in the tree.  Placements wait until we can afford them.
+    void apply(const Action& action)
+    {
+        if (action.m_Type == iEntityStats::InvalidMobType)
+        {
+            advance(ksWaitSec);
+            return;
+        }
+
+        const float giveUpTime = m_State.getTime() + ksMaxSaveSec;
+        while (!m_State.canPlace(m_bNorth, action.m_Type) && (m_State.getTime() < giveUpTime) && !isOver())
+        {
+            advance(ksStepSec);
+        }
+        if (m_State.canPlace(m_bNorth, action.m_Type))
+        {
+            m_State.place(m_bNorth, action.m_Type, action.m_X, action.m_Y);
+        }
+    }
+
+    bool isOver() const { return m_State.isKingDead(true) || m_State.isKingDead(false); }
+
+    void playout(const ForwardModel& root)
+    {
+        m_State = root;
+        m_OurThreshold = randomFloat(2.f, 9.f);
+        m_OpponentThreshold = randomFloat(2.f, 9.f);
+
+        // Down the tree...
+        uint32_t path[ksMaxDepth + 1];
+        int depth = 0;
+        uint32_t node = 0;
+        path[depth++] = node;
+        while ((depth <= ksMaxDepth) && !isOver())
+        {
+            if (m_Nodes[node].m_NumChildren == 0)
+            {
+                // Only grow the tree from nodes we've been to before.
+                if ((m_Nodes[node].m_Visits == 0) || !expand(node))
+                    break;
+            }
+
+            const uint32_t child = select(node);
+            apply(m_pActions[0][child - m_Nodes[node].m_FirstChild]);
+            node = child;
+            path[depth++] = node;
+        }
+
+        // ... then randomly to the horizon.
+        while ((m_State.getTime() < m_HorizonSec) && !isOver())
+        {
+            playRandomly(true);
+            playRandomly(false);
+            m_State.step(ksStepSec);
+        }
+
+        const float value = m_State.evaluate(m_bNorth);
+        for (int i = 0; i < depth; ++i)
+        {
+            ++m_Nodes[path[i]].m_Visits;
+            m_Nodes[path[i]].m_TotalValue += value;
+        }
+        ++m_NumPlayouts;
+    }
+
+private:
+    std::vector<Node> m_Nodes;
+    ForwardModel m_State;
+    uint32_t m_Rng;
+    unsigned long long m_NumPlayouts;
+
+    const std::vector<Action>* m_pActions;      // ours, then theirs
+    bool m_bNorth;
+    float m_HorizonSec;
+    float m_OpponentThreshold;
+    float m_OurThreshold;
+};
+
+Controller_AI_MCTS::Controller_AI_MCTS()
+{
+    init();
+}
+
+Controller_AI_MCTS::Controller_AI_MCTS(const Settings& settings)
+    : m_Settings(settings)
+{
+    init();
+}
+
+void Controller_AI_MCTS::init()
+{
+    m_TimeSinceDecision = 0.f;
+    m_Stats = Stats();
+    m_bSearching = false;
+    m_DecisionSearchSec = 0.;
+    m_Generation = 0;
+    m_NumRunning = 0;
+    m_bQuit = false;
+
+    const unsigned int numThreads = std::max(m_Settings.m_NumThreads, 1u);
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        m_Searchers.push_back(new Searcher(m_Settings.m_Seed + i * 7919));
+    }
+    for (unsigned int i = 1; i < numThreads; ++i)
+    {
+        m_Threads.emplace_back(&Controller_AI_MCTS::workerMain, this, i);
+    }
+}
+
+Controller_AI_MCTS::~Controller_AI_MCTS()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeLock);
+        m_bQuit = true;
+    }
+    m_WakeCond.notify_all();
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+
+    for (Searcher* pSearcher : m_Searchers)
+    {
+        delete pSearcher;
+    }
+}
+
+double Controller_AI_MCTS::getPlayoutsPerSecond() const
+{
+    return (m_Stats.m_SearchSec > 0.) ? (double)m_Stats.m_NumPlayouts / m_Stats.m_SearchSec : 0.;
+}
+
+void Controller_AI_MCTS::buildActions()
+{
+    // The spots, in player space (i.e. as if we were north): at the front of
+    // each bridge, in front of each princess tower, and in front of the king.
+    const ArenaLayout& layout = m_pPlayer->getLayout();
+    Vec2 spots[5];
+    int numSpots = 0;
+    for (bool bLeft : { true, false })
+    {
+        const float x = layout.getBridgeCenterX(bLeft);
+        spots[numSpots++] = Vec2(x, layout.getRiverTopY() - 0.5f);
+        spots[numSpots++] = Vec2(x, (float)layout.getPrincessPos(true, bLeft).y + 2.f);
+    }
+    spots[numSpots++] = Vec2((float)layout.getWidth() / 2.f + 0.5f, (float)layout.getKingPos(true).y + 3.5f);
+
+    // We only know which mob types we have, so the opponent can have any.
+    const std::vector<iEntityStats::MobType>& ourTypes = m_pPlayer->GetAvailableMobTypes();
+    for (int side = 0; side < 2; ++side)
+    {
+        const bool bOurs = (side == 0);
+        const bool bNorth = bOurs ? m_pPlayer->isNorth() : !m_pPlayer->isNorth();
+        std::vector<Action>& actions = m_Actions[side];
+        actions.clear();
+
+        Action wait = { iEntityStats::InvalidMobType, 0.f, 0.f };
+        actions.push_back(wait);
+
+        const size_t numTypes = bOurs ? ourTypes.size() : (size_t)iEntityStats::numMobTypes;
+        for (size_t t = 0; t < numTypes; ++t)
+        {
+            const iEntityStats::MobType type = bOurs ? ourTypes[t] : (iEntityStats::MobType)t;
+            for (int i = 0; i < numSpots; ++i)
+            {
+                const Vec2 pos = layout.playerToGame(spots[i], bNorth);
+                const Action action = { type, (float)pos.x, (float)pos.y };
+                actions.push_back(action);
+            }
+        }
+    }
+}
+
+void Controller_AI_MCTS::startSearch()
+{
+    buildActions();
+    m_Root.capture(*m_pPlayer);
+    for (Searcher* pSearcher : m_Searchers)
+    {
+        pSearcher->reset(m_pPlayer->isNorth(), m_Actions, m_Settings);
+    }
+
+    m_bSearching = true;
+    m_DecisionSearchSec = 0.;
+}
+
+const Controller_AI_MCTS::Action& Controller_AI_MCTS::finishSearch()
+{
+    m_bSearching = false;
+
+    m_Visits.assign(m_Actions[0].size(), 0);
+    for (const Searcher* pSearcher : m_Searchers)
+    {
+        pSearcher->addRootVisits(m_Visits);
+        m_Stats.m_NumPlayouts += pSearcher->getNumPlayouts();
+    }
+    ++m_Stats.m_NumDecisions;
+
+    // The most visited option is the one the search trusts the most.
+    const size_t best = std::max_element(m_Visits.begin(), m_Visits.end()) - m_Visits.begin();
+    return m_Actions[0][best];
+}
+
+void Controller_AI_MCTS::runSearchers(std::chrono::steady_clock::time_point deadline)
+{
+    // Root parallelization: every searcher grows its own tree from the same
+    // root, and they only meet again in finishSearch().
+    if (!m_Threads.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_WakeLock);
+            m_Deadline = deadline;
+            m_NumRunning = (unsigned int)m_Threads.size();
+            ++m_Generation;
+        }
+        m_WakeCond.notify_all();
+    }
+
+    m_Searchers[0]->run(m_Root, deadline);
+
+    std::unique_lock<std::mutex> lock(m_WakeLock);
+    m_DoneCond.wait(lock, [this] { return m_NumRunning == 0; });
+}
+
+void Controller_AI_MCTS::workerMain(unsigned int searcher)
+{
+    unsigned long long generation = 0;
+    std::unique_lock<std::mutex> lock(m_WakeLock);
+    while (true)
+    {
+        m_WakeCond.wait(lock, [&] { return m_bQuit || (m_Generation != generation); });
+        if (m_bQuit)
+            return;
+
+        generation = m_Generation;
+        const std::chrono::steady_clock::time_point deadline = m_Deadline;
+        lock.unlock();
+        m_Searchers[searcher]->run(m_Root, deadline);
+        lock.lock();
+
+        if (--m_NumRunning == 0)
+            m_DoneCond.notify_one();
+    }
+}
+
+void Controller_AI_MCTS::tick(float deltaTSec)
+{
+    assert(m_pPlayer);
+
+    m_TimeSinceDecision += deltaTSec;
+
+    // The search has had its budget (over however many think()s it took), 
+    // so go with what it found.  The elixir may have changed since it 
+    // started, in which case placing fails and we'll just try again next
+    // time.  Our spots are all valid, so nothing else can go wrong.
+    if (m_bSearching)
+    {
+        if (m_DecisionSearchSec * 1000. < (double)m_Settings.m_DecisionBudgetMs)
+            return;
+
+        const Action& action = finishSearch();
+        if ((action.m_Type != iEntityStats::InvalidMobType) &&
+            (m_pPlayer->placeMob(action.m_Type, Vec2(action.m_X, action.m_Y)) == iPlayer::Success))
+        {
+            ++m_Stats.m_NumPlacements;
+        }
+        return;
+    }
+
+    if (m_TimeSinceDecision < m_Settings.m_DecisionIntervalSec)
+        return;
+
+    // There's no point searching if we can't place anything yet.
+    const std::vector<iEntityStats::MobType>& types = m_pPlayer->GetAvailableMobTypes();
+    bool bCanAfford = false;
+    for (iEntityStats::MobType type : types)
+    {
+        bCanAfford = bCanAfford || (m_pPlayer->getElixir() >= iEntityStats::getStats(type).getElixirCost());
+    }
+    if (!bCanAfford)
+        return;
+    m_TimeSinceDecision = 0.f;
+
+    startSearch();
+}
+
+void Controller_AI_MCTS::think(std::chrono::steady_clock::time_point deadline)
+{
+    if (!m_bSearching)
+        return;
+
+    // Don't go past the budget for this decision either.
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    const double budgetLeftMs = (double)m_Settings.m_DecisionBudgetMs - m_DecisionSearchSec * 1000.;
+    if (budgetLeftMs <= 0.)
+        return;
+    deadline = std::min(deadline, start + duration_cast<steady_clock::duration>(duration<double, std::milli>(budgetLeftMs)));
+
+    runSearchers(deadline);
+
+    const double sec = duration<double>(steady_clock::now() - start).count();
+    m_DecisionSearchSec += sec;
+    m_Stats.m_SearchSec += sec;
+}
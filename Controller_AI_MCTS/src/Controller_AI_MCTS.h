@@ -0,0 +1,135 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ForwardModel.h"
+#include "iController.h"
+#include "Vec2.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Decides what to place, and where, with Monte Carlo Tree Search.  
+//
+// Every so often (if we can afford anything) tick() copies the game into a
+// ForwardModel, and think() then searches over our options: each of our mob types at each
+// of a handful of spots (at the bridges, in front of the princess towers,
+// in front of the king), or waiting.  The opponent plays randomly in the 
+// model, and so do we once we're past the tree.  Playouts look a fixed 
+// time ahead and are scored by ForwardModel::evaluate().  The search can 
+// span several calls to think(), and once it has had its budget the next 
+// tick() places the winner.  
+//
+// With more than one thread, each thread grows its own tree from the same
+// root (root parallelization), and we add up their visit counts at the end.
+// The threads are started once, up front, and wait for think() to give 
+// them something to do.
+// NOTE: the number of playouts depends on how fast the machine is, so 
+// matches against this controller aren't reproducible.  It also only 
+// searches in think(), so it never places anything in a game that doesn't
+// call that.
+class Controller_AI_MCTS : public iController
+{
+public:
+    struct Settings
+    {
+        float m_DecisionBudgetMs;       // how long each decision searches for
+        unsigned int m_NumThreads;      // how many trees to grow at once
+        float m_DecisionIntervalSec;    // game time between decisions
+        float m_HorizonSec;             // how far ahead a playout looks
+        unsigned int m_Seed;
+
+        Settings();
+    };
+
+    Controller_AI_MCTS();
+    explicit Controller_AI_MCTS(const Settings& settings);
+    virtual ~Controller_AI_MCTS();
+
+    void tick(float deltaTSec);
+    void think(std::chrono::steady_clock::time_point deadline);
+
+    // Playouts per second is the number to watch - it's what decides how 
+    // well the search plays in a given budget.
+    struct Stats
+    {
+        unsigned int m_NumDecisions;
+        unsigned int m_NumPlacements;
+        unsigned long long m_NumPlayouts;
+        double m_SearchSec;             // wall clock, summed over decisions
+    };
+    const Stats& getStats() const { return m_Stats; }
+    double getPlayoutsPerSecond() const;
+
+    // One option at a decision.  InvalidMobType means wait.
+    struct Action
+    {
+        iEntityStats::MobType m_Type;
+        float m_X;                      // in game space
+        float m_Y;
+    };
+
+private:
+    class Searcher;
+
+    void init();
+    void buildActions();
+    void startSearch();
+    const Action& finishSearch();
+
+    // Runs every searcher until the deadline, m_Searchers[0] on this thread.
+    void runSearchers(std::chrono::steady_clock::time_point deadline);
+    void workerMain(unsigned int searcher);
+
+private:
+    Settings m_Settings;
+    float m_TimeSinceDecision;
+    ForwardModel m_Root;
+
+    // Ours, then the opponent's (for its random play in the model).
+    std::vector<Action> m_Actions[2];
+
+    std::vector<Searcher*> m_Searchers;     // owned
+    std::vector<unsigned long long> m_Visits;
+    Stats m_Stats;
+
+    bool m_bSearching;                      // between startSearch() and finishSearch()
+    double m_DecisionSearchSec;             // how much of the budget this decision has used
+
+    std::vector<std::thread> m_Threads;     // m_Threads[i] runs m_Searchers[i + 1]
+    std::mutex m_WakeLock;
+    std::condition_variable m_WakeCond;
+    std::condition_variable m_DoneCond;
+    unsigned long long m_Generation;        // bumped every runSearchers()
+    std::chrono::steady_clock::time_point m_Deadline;
+    unsigned int m_NumRunning;
+    bool m_bQuit;
+
+private:
+    // DELIBERATELY UNDEFINED
+    Controller_AI_MCTS(const Controller_AI_MCTS& rhs);
+    Controller_AI_MCTS& operator=(const Controller_AI_MCTS& rhs);
+};
@@ -0,0 +1,311 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ForwardModel.h"
+
+#include "Constants.h"
+#include "iPlayer.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+    // The stats we need, copied out of iEntityStats so that the inner loops
+    // don't make virtual calls.  Mob types first, then buildings.
+    struct TypeInfo
+    {
+        float m_Speed;
+        float m_Size;
+        float m_AttackRange;
+        float m_AttackTime;
+        float m_SightRadius;
+        float m_ElixirCost;
+        int m_Damage;
+        int m_MaxHealth;
+        bool m_bMelee;
+        iEntityStats::TargetType m_TargetType;
+    };
+
+    static const int ksNumTypes = iEntityStats::numMobTypes + iEntityStats::numBuildingTypes;
+
+    struct TypeTable
+    {
+        TypeInfo m_Types[ksNumTypes];
+
+        TypeTable()
+        {
+            for (int i = 0; i < ksNumTypes; ++i)
+            {
+                const bool bBuilding = (i >= iEntityStats::numMobTypes);
+                const iEntityStats& stats = bBuilding 
+                    ? iEntityStats::getBuildingStats((iEntityStats::BuildingType)(i - iEntityStats::numMobTypes))
+                    : iEntityStats::getStats((iEntityStats::MobType)i);
+
+                TypeInfo& type = m_Types[i];
+                type.m_Speed = bBuilding ? 0.f : stats.getSpeed();
+                type.m_Size = stats.getSize();
+                type.m_AttackRange = stats.getAttackRange();
+                type.m_AttackTime = stats.getAttackTime();
+                type.m_SightRadius = stats.getSightRadius();
+                type.m_ElixirCost = bBuilding ? 0.f : stats.getElixirCost();
+                type.m_Damage = stats.getDamage();
+                type.m_MaxHealth = stats.getMaxHealth();
+                type.m_bMelee = (stats.getDamageType() == iEntityStats::Melee);
+                type.m_TargetType = stats.getTargetType();
+            }
+        }
+    };
+
+    const TypeInfo& getType(int index)
+    {
+        static const TypeTable s_Table;
+        return s_Table.m_Types[index];
+    }
+}
+
+ForwardModel::ForwardModel()
+    : m_Time(0.f)
+    , m_NumUnits(0)
+{
+    m_Elixir[0] = m_Elixir[1] = 0.f;
+}
+
+void ForwardModel::capture(const iPlayer& player)
+{
+    m_Layout = player.getLayout();
+    m_Time = 0.f;
+    m_Elixir[0] = m_Elixir[1] = player.getElixir();
+    m_NumUnits = ksNumBuildings;
+
+    const bool bNorth = player.isNorth();
+    for (bool bOurs : { true, false })
+    {
+        const bool bUnitNorth = bOurs ? bNorth : !bNorth;
+        const unsigned int numBuildings = bOurs ? player.getNumBuildings() : player.getNumOpponentBuildings();
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            Unit& unit = m_Units[(bUnitNorth ? 0 : 3) + i];
+            if (i >= numBuildings)
+            {
+                unit.m_Health = 0;
+                continue;
+            }
+
+            const iPlayer::EntityData data = bOurs ? player.getBuilding(i) : player.getOpponentBuilding(i);
+            unit.m_X = (float)data.m_Position.x;
+            unit.m_Y = (float)data.m_Position.y;
+            unit.m_Health = data.m_Health;
+            unit.m_Type = (uint8_t)getTypeIndex(data.m_Stats.getBuildingType());
+            unit.m_bNorth = bUnitNorth;
+            unit.m_Cooldown = 0.f;
+        }
+
+        // We don't know when their next attacks are ready, so call it half
+        // way.
+        const unsigned int numMobs = bOurs ? player.getNumMobs() : player.getNumOpponentMobs();
+        for (unsigned int i = 0; (i < numMobs) && (m_NumUnits < ksMaxUnits); ++i)
+        {
+            const iPlayer::EntityData data = bOurs ? player.getMob(i) : player.getOpponentMob(i);
+            if (data.m_Health <= 0)
+                continue;
+
+            Unit& unit = m_Units[m_NumUnits++];
+            unit.m_X = (float)data.m_Position.x;
+            unit.m_Y = (float)data.m_Position.y;
+            unit.m_Health = data.m_Health;
+            unit.m_Type = (uint8_t)getTypeIndex(data.m_Stats.getMobType());
+            unit.m_bNorth = bUnitNorth;
+            unit.m_Cooldown = getType(unit.m_Type).m_AttackTime / 2.f;
+        }
+    }
+}
+
+bool ForwardModel::canPlace(bool bNorth, iEntityStats::MobType type) const
+{
+    return getElixir(bNorth) >= getType(getTypeIndex(type)).m_ElixirCost;
+}
+
+void ForwardModel::place(bool bNorth, iEntityStats::MobType type, float x, float y)
+{
+    const TypeInfo& info = getType(getTypeIndex(type));
+    m_Elixir[bNorth ? 0 : 1] -= info.m_ElixirCost;
+    if (m_NumUnits == ksMaxUnits)
+        return;
+
+    Unit& unit = m_Units[m_NumUnits++];
+    unit.m_X = x;
+    unit.m_Y = y;
+    unit.m_Health = info.m_MaxHealth;
+    unit.m_Type = (uint8_t)getTypeIndex(type);
+    unit.m_bNorth = bNorth;
+    unit.m_Cooldown = info.m_AttackTime;
+}
+
+bool ForwardModel::pickDestination(const Unit& unit, int target, float& x, float& y) const
+{
+    // Go for the target if it's on our side of the river (like Mob::move()).
+    const float halfHeight = (float)(m_Layout.getHeight() / 2);
+    if ((target >= 0) && ((unit.m_Y < halfHeight) == (m_Units[target].m_Y < halfHeight)))
+    {
+        x = m_Units[target].m_X;
+        y = m_Units[target].m_Y;
+        return true;
+    }
+
+    // Otherwise down our lane: to the far end of the bridge, then on to the
+    // princess tower at the end of it, then the king.
+    const bool bLeftLane = unit.m_X < (float)m_Layout.getWidth() / 2.f;
+    const bool bCrossed = unit.m_bNorth ? (unit.m_Y > m_Layout.getRiverBotY()) : (unit.m_Y < m_Layout.getRiverTopY());
+    if (!bCrossed)
+    {
+        x = m_Layout.getBridgeCenterX(bLeftLane);
+        y = unit.m_bNorth ? m_Layout.getRiverBotY() + 0.5f : m_Layout.getRiverTopY() - 0.5f;
+        return false;
+    }
+
+    const int enemyKing = unit.m_bNorth ? 3 : 0;
+    const Unit& princess = m_Units[enemyKing + (bLeftLane ? 1 : 2)];
+    const Unit& tower = (princess.m_Health > 0) ? princess : m_Units[enemyKing];
+    x = tower.m_X;
+    y = tower.m_Y;
+    return false;
+}
+
+void ForwardModel::step(float deltaTSec)
+{
+    m_Time += deltaTSec;
+    for (float& elixir : m_Elixir)
+    {
+        elixir = std::min(elixir + deltaTSec * ELIXIR_PER_SECOND, MAX_ELIXIR);
+    }
+
+    // Damage is applied once everyone has acted, like the Game does.  
+    // Movement isn't, which is one of the ways that this is cheaper.
+    int damage[ksMaxUnits] = {};
+    for (int i = 0; i < m_NumUnits; ++i)
+    {
+        Unit& unit = m_Units[i];
+        if (unit.m_Health <= 0)
+            continue;
+
+        const TypeInfo& type = getType(unit.m_Type);
+        unit.m_Cooldown -= deltaTSec;
+
+        // The closest enemy that we can see (and are allowed to attack).
+        int target = -1;
+        float closestDistSq = type.m_SightRadius * type.m_SightRadius;
+        const int first = (type.m_TargetType == iEntityStats::Mob) ? ksNumBuildings : 0;
+        const int last = (type.m_TargetType == iEntityStats::Building) ? ksNumBuildings : m_NumUnits;
+        for (int j = first; j < last; ++j)
+        {
+            const Unit& other = m_Units[j];
+            if ((other.m_bNorth == unit.m_bNorth) || (other.m_Health <= 0))
+                continue;
+
+            const float dx = other.m_X - unit.m_X;
+            const float dy = other.m_Y - unit.m_Y;
+            const float distSq = dx * dx + dy * dy;
+            if (distSq < closestDistSq)
+            {
+                closestDistSq = distSq;
+                target = j;
+            }
+        }
+
+        float contactDist = 0.f;
+        if (target >= 0)
+        {
+            contactDist = (type.m_Size + getType(m_Units[target].m_Type).m_Size) / 2.f;
+            const float range = type.m_AttackRange + (type.m_bMelee ? contactDist : 0.f);
+            if (closestDistSq <= range * range)
+            {
+                if (unit.m_Cooldown <= 0.f)
+                {
+                    damage[target] += type.m_Damage;
+                    unit.m_Cooldown = type.m_AttackTime;
+                }
+                continue;
+            }
+        }
+
+        if (type.m_Speed <= 0.f)
+            continue;
+
+        float destX, destY;
+        const bool bToTarget = pickDestination(unit, target, destX, destY);
+
+        const float dx = destX - unit.m_X;
+        const float dy = destY - unit.m_Y;
+        const float dist = sqrtf(dx * dx + dy * dy);
+        const float remaining = dist - (bToTarget ? contactDist : 0.f);
+        const float moveDist = std::min(type.m_Speed * deltaTSec, remaining);
+        if ((moveDist > 0.f) && (dist > 0.f))
+        {
+            unit.m_X += dx * (moveDist / dist);
+            unit.m_Y += dy * (moveDist / dist);
+        }
+    }
+
+    // Apply the damage, and take out the dead mobs (in order, so that the
+    // results don't depend on who died).
+    int numAlive = ksNumBuildings;
+    for (int i = 0; i < m_NumUnits; ++i)
+    {
+        m_Units[i].m_Health -= damage[i];
+        if (i < ksNumBuildings)
+            continue;
+        if (m_Units[i].m_Health > 0)
+            m_Units[numAlive++] = m_Units[i];
+    }
+    m_NumUnits = numAlive;
+}
+
+float ForwardModel::evaluate(bool bNorth) const
+{
+    const bool bWeLost = isKingDead(bNorth);
+    const bool bTheyLost = isKingDead(!bNorth);
+    if (bWeLost != bTheyLost)
+        return bTheyLost ? 1.f : 0.f;
+
+    // The king counts double, since losing it loses the match.
+    float towers[2] = { 0.f, 0.f };
+    float mobHealth[2] = { 0.f, 0.f };
+    for (int i = 0; i < m_NumUnits; ++i)
+    {
+        const Unit& unit = m_Units[i];
+        const int side = (unit.m_bNorth == bNorth) ? 0 : 1;
+        const float health = (float)std::max(unit.m_Health, 0);
+        if (i < ksNumBuildings)
+        {
+            const float weight = ((i % 3) == 0) ? 2.f : 1.f;
+            towers[side] += weight * health / (float)getType(unit.m_Type).m_MaxHealth / 4.f;
+        }
+        else
+        {
+            mobHealth[side] += health;
+        }
+    }
+
+    const float mobs = (mobHealth[0] - mobHealth[1]) / (mobHealth[0] + mobHealth[1] + 1.f);
+    return std::min(1.f, std::max(0.f, 0.5f + 0.4f * (towers[0] - towers[1]) + 0.1f * mobs));
+}
@@ -0,0 +1,101 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "EntityStats.h"
+
+#include <stdint.h>
+
+class iPlayer;
+
+// A stripped-down copy of the Game, for searching through possible futures.
+// It keeps the parts that decide who wins a fight (targeting, attack 
+// ranges and cooldowns, damage, movement down the lanes, elixir) and drops
+// the rest (collisions, steering, timers, the Rogue's special abilities).
+// Mobs walk straight to the far end of their lane's bridge, then straight 
+// at the nearest standing tower in their lane.
+//
+// Everything lives in fixed size arrays, so a ForwardModel can be copied 
+// with a memcpy and stepped without allocating - a playout is just a copy
+// of the root state and a loop over step().
+class ForwardModel
+{
+public:
+    // Mobs past this many are dropped when they spawn.  Buildings come first,
+    // so they always fit.
+    static const int ksMaxUnits = 96;
+    static const int ksNumBuildings = 6;
+
+    struct Unit
+    {
+        float m_X;
+        float m_Y;
+        float m_Cooldown;           // until our next attack
+        int m_Health;
+        uint8_t m_Type;             // index into the type table (see getTypeIndex())
+        bool m_bNorth;
+    };
+
+    ForwardModel();
+
+    // Copy the current state of the game, as player sees it.  We can't see
+    // the opponent's elixir, so we guess that it's the same as ours.
+    void capture(const iPlayer& player);
+
+    // Bypasses the river check, so only give it valid positions.
+    bool canPlace(bool bNorth, iEntityStats::MobType type) const;
+    void place(bool bNorth, iEntityStats::MobType type, float x, float y);
+
+    void step(float deltaTSec);
+
+    float getTime() const { return m_Time; }
+    float getElixir(bool bNorth) const { return m_Elixir[bNorth ? 0 : 1]; }
+    int getNumUnits() const { return m_NumUnits; }
+
+    // Has this side's king tower fallen?
+    bool isKingDead(bool bNorth) const { return m_Units[bNorth ? 0 : 3].m_Health <= 0; }
+
+    // How well things are going for bNorth, from 0 (lost) to 1 (won).  
+    // Mostly tower health, with a bit for the mobs each side has left.
+    float evaluate(bool bNorth) const;
+
+private:
+    static int getTypeIndex(iEntityStats::MobType type) { return (int)type; }
+    static int getTypeIndex(iEntityStats::BuildingType type) { return (int)iEntityStats::numMobTypes + (int)type; }
+
+    // Where a mob with this target (or -1) walks to.  Returns true if it's
+    // going for the target.
+    bool pickDestination(const Unit& unit, int target, float& x, float& y) const;
+
+private:
+    ArenaLayout m_Layout;
+    float m_Time;
+    float m_Elixir[2];              // north, south
+    int m_NumUnits;
+
+    // North's king, left and right princess towers, then south's, then the
+    // mobs.  Dead buildings stay where they are (with no health), dead mobs
+    // are removed.
+    Unit m_Units[ksMaxUnits];
+};
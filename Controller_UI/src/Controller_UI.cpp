@@ -33,8 +33,6 @@ Controller_UI* Singleton<Controller_UI>::s_Obj = NULL;
 
 Controller_UI::~Controller_UI()
 {
-    std::cout << "Controller_UI is being deleted. This probably means that "
-        << "you made more than one." << std::endl;
 }
 
 void Controller_UI::tick(float deltaTSec) {
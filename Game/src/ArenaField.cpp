@@ -0,0 +1,167 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ArenaField.h"
+
+#include <algorithm>
+
+// These work for both float and Fixed.
+static Real absReal(Real r) { return (r < Real(0)) ? Real(0) - r : r; }
+static int floorToInt(Real r)
+{
+    int i = (int)r;
+    return (Real(i) > r) ? i - 1 : i;
+}
+
+// Signed distance to an axis aligned box (negative inside).
+static Real boxDistance(const Vec2& pos, const Vec2& center, const Vec2& halfSize)
+{
+    const Real qx = absReal(pos.x - center.x) - halfSize.x;
+    const Real qy = absReal(pos.y - center.y) - halfSize.y;
+    const Vec2 outside(std::max(qx, Real(0)), std::max(qy, Real(0)));
+    return outside.length() + std::min(std::max(qx, qy), Real(0));
+}
+
+ArenaField::ArenaField(const ArenaLayout& layout)
+    : m_Layout(layout)
+    , m_CellsPerMeter(ksMaxCellsPerMeter)
+{
+    const int area = layout.getWidth() * layout.getHeight();
+    while ((m_CellsPerMeter > 1) && (area * m_CellsPerMeter * m_CellsPerMeter > ksMaxSamples))
+    {
+        --m_CellsPerMeter;
+    }
+    m_Width = layout.getWidth() * m_CellsPerMeter;
+    m_Height = layout.getHeight() * m_CellsPerMeter;
+
+    build(std::vector<Circle>());
+}
+
+Real ArenaField::distanceAt(const Vec2& pos) const
+{
+    // The arena edges: everything outside of the arena is solid.
+    const ArenaLayout& layout = m_Layout;
+    const Vec2 arenaHalf(layout.getWidth() / 2.f, layout.getHeight() / 2.f);
+    Real dist = -boxDistance(pos, arenaHalf, arenaHalf);
+
+    // The river, minus the bridges.
+    const Vec2 riverCenter(layout.getWidth() / 2.f, (layout.getRiverTopY() + layout.getRiverBotY()) / 2.f);
+    const Vec2 riverHalf(layout.getWidth() / 2.f + 1.f, (layout.getRiverBotY() - layout.getRiverTopY()) / 2.f);
+    const Vec2 bridgeHalf(layout.getBridgeWidth() / 2.f, layout.getBridgeHeight() / 2.f);
+    Real river = boxDistance(pos, riverCenter, riverHalf);
+    river = std::max(river, -boxDistance(pos, Vec2(layout.getBridgeCenterX(true), layout.getBridgeCenterY()), bridgeHalf));
+    river = std::max(river, -boxDistance(pos, Vec2(layout.getBridgeCenterX(false), layout.getBridgeCenterY()), bridgeHalf));
+    dist = std::min(dist, river);
+
+    for (const Circle& tower : m_Towers)
+    {
+        dist = std::min(dist, pos.dist(tower.m_Center) - tower.m_Radius);
+    }
+
+    return dist;
+}
+
+void ArenaField::build(const std::vector<Circle>& towers)
+{
+    m_Towers = towers;
+    m_Samples.resize(m_Width * m_Height);
+
+    const Real cellSize = Real(1) / Real(m_CellsPerMeter);
+    const Real half = cellSize / Real(2);
+    for (int y = 0; y < m_Height; ++y)
+    {
+        for (int x = 0; x < m_Width; ++x)
+        {
+            const Vec2 pos(Real(x) * cellSize + half, Real(y) * cellSize + half);
+            m_Samples[y * m_Width + x].m_Dist = distanceAt(pos);
+        }
+    }
+
+    // The gradient comes from the neighboring samples (central differences,
+    // or one sided along the edges), which is a lot cheaper than evaluating
+    // every obstacle again.
+    for (int y = 0; y < m_Height; ++y)
+    {
+        const int yLo = std::max(y - 1, 0);
+        const int yHi = std::min(y + 1, m_Height - 1);
+        for (int x = 0; x < m_Width; ++x)
+        {
+            const int xLo = std::max(x - 1, 0);
+            const int xHi = std::min(x + 1, m_Width - 1);
+            Vec2 grad(m_Samples[y * m_Width + xHi].m_Dist - m_Samples[y * m_Width + xLo].m_Dist,
+                      m_Samples[yHi * m_Width + x].m_Dist - m_Samples[yLo * m_Width + x].m_Dist);
+            grad.normalize();
+
+            Sample& s = m_Samples[y * m_Width + x];
+            s.m_GradX = grad.x;
+            s.m_GradY = grad.y;
+        }
+    }
+
+    m_Towers.clear();
+}
+
+Real ArenaField::sample(const Vec2& pos, Vec2& gradient) const
+{
+    // Bilinear interpolation between the four nearest samples.  Past the 
+    // outermost samples we use the nearest point on the edge of the grid, 
+    // and add on how far we are from it (everything out there is solid).
+    const Real cellSize = Real(1) / Real(m_CellsPerMeter);
+    const Real half = cellSize / Real(2);
+    const Vec2 clamped(std::min(std::max(pos.x, half), Real(m_Width) * cellSize - half),
+                       std::min(std::max(pos.y, half), Real(m_Height) * cellSize - half));
+    const Real outside = (clamped == pos) ? Real(0) : pos.dist(clamped);
+
+    const Real fx = clamped.x * Real(m_CellsPerMeter) - Real(0.5f);
+    const Real fy = clamped.y * Real(m_CellsPerMeter) - Real(0.5f);
+    const int x0 = std::min(std::max(floorToInt(fx), 0), m_Width - 2);
+    const int y0 = std::min(std::max(floorToInt(fy), 0), m_Height - 2);
+    const Real tx = std::min(std::max(fx - Real(x0), Real(0)), Real(1));
+    const Real ty = std::min(std::max(fy - Real(y0), Real(0)), Real(1));
+
+    const Sample& s00 = m_Samples[y0 * m_Width + x0];
+    const Sample& s10 = m_Samples[y0 * m_Width + x0 + 1];
+    const Sample& s01 = m_Samples[(y0 + 1) * m_Width + x0];
+    const Sample& s11 = m_Samples[(y0 + 1) * m_Width + x0 + 1];
+
+    const Real w00 = (Real(1) - tx) * (Real(1) - ty);
+    const Real w10 = tx * (Real(1) - ty);
+    const Real w01 = (Real(1) - tx) * ty;
+    const Real w11 = tx * ty;
+
+    gradient = Vec2(s00.m_GradX * w00 + s10.m_GradX * w10 + s01.m_GradX * w01 + s11.m_GradX * w11,
+                    s00.m_GradY * w00 + s10.m_GradY * w10 + s01.m_GradY * w01 + s11.m_GradY * w11);
+    gradient.normalize();
+
+    return s00.m_Dist * w00 + s10.m_Dist * w10 + s01.m_Dist * w01 + s11.m_Dist * w11 - outside;
+}
+
+bool ArenaField::pushOut(Vec2& pos, Real radius) const
+{
+    Vec2 gradient;
+    const Real dist = sample(pos, gradient);
+    if (dist >= radius)
+        return false;
+
+    pos += gradient * (radius - dist);
+    return true;
+}
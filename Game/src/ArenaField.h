@@ -0,0 +1,89 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "Vec2.h"
+
+#include <vector>
+
+// A signed distance field for the parts of the arena that mobs can't walk 
+// through: the river (except where the bridges cross it), the towers, and 
+// the edges of the arena.  It's baked into a grid up front, so keeping a 
+// mob out of all of them is one lookup, rather than a test against each 
+// obstacle.
+//
+// Distances are positive in open ground and negative inside an obstacle, 
+// and the gradient points away from the nearest obstacle.  Between samples
+// both are interpolated.
+class ArenaField
+{
+public:
+    // Resolution of the grid.  Big arenas get fewer samples per meter, to 
+    // keep the grid (and the time to rebake it) bounded.
+    static const int ksMaxCellsPerMeter = 8;
+    static const int ksMaxSamples = 1 << 20;
+
+    struct Circle
+    {
+        Vec2 m_Center;
+        Real m_Radius;
+    };
+
+    explicit ArenaField(const ArenaLayout& layout);
+
+    // Bake the field.  The river, bridges and edges come from the layout.
+    // Towers are circles, the same as they are for attack ranges.  This is
+    // cheap enough to redo when a tower falls.
+    void build(const std::vector<Circle>& towers);
+
+    // The distance to the nearest obstacle, and its gradient.
+    Real sample(const Vec2& pos, Vec2& gradient) const;
+
+    // If a circle of this radius at pos overlaps an obstacle, move it out
+    // (along the gradient) and return true.
+    bool pushOut(Vec2& pos, Real radius) const;
+
+private:
+    struct Sample
+    {
+        Real m_Dist;
+        Real m_GradX;
+        Real m_GradY;
+    };
+
+    Real distanceAt(const Vec2& pos) const;
+
+private:
+    ArenaLayout m_Layout;
+    int m_CellsPerMeter;
+    int m_Width;                    // in samples
+    int m_Height;
+    std::vector<Sample> m_Samples;  // row major, sample (x, y) is at ((x, y) + 0.5) / m_CellsPerMeter
+    std::vector<Circle> m_Towers;   // just while we build
+
+private:
+    // DELIBERATELY UNDEFINED
+    ArenaField(const ArenaField& rhs);
+    ArenaField& operator=(const ArenaField& rhs);
+};
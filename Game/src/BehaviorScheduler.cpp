@@ -0,0 +1,185 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BehaviorScheduler.h"
+
+#include "Mob.h"
+
+#include <assert.h>
+
+Behavior::Behavior(Mob& mob)
+    : m_Mob(mob)
+    , m_pScheduler(NULL)
+    , m_pFrame(NULL)
+    , m_DueTime(FLT_MAX)
+    , m_NumTimers(0)
+    , m_bReady(false)
+    , m_bStopped(false)
+{
+}
+
+void Behavior::onTimer(float now)
+{
+    assert(!!m_pScheduler);
+    m_pScheduler->onTimer(this, now);
+}
+
+BehaviorScheduler::BehaviorScheduler(TimingWheel& timers)
+    : m_Timers(timers)
+    , m_NumBehaviors(0)
+    , m_NumResumed(0)
+{
+}
+
+BehaviorScheduler::~BehaviorScheduler()
+{
+    for (Frame* pChunk : m_Chunks)
+    {
+        delete[] pChunk;
+    }
+}
+
+void BehaviorScheduler::stop(Behavior* pBehavior)
+{
+    if (!pBehavior)
+        return;
+
+    pBehavior->m_bStopped = true;
+    releaseIfUnused(pBehavior);
+}
+
+void BehaviorScheduler::wake(Behavior* pBehavior)
+{
+    if (!!pBehavior && !pBehavior->m_bStopped)
+    {
+        makeReady(pBehavior);
+    }
+}
+
+void BehaviorScheduler::run(float now)
+{
+    // Nothing becomes ready while we're running (timers fire and wake-ups 
+    // come in during the tick), but swap the list out anyway, so that a
+    // behavior that did could never be resumed twice in one run.
+    m_Running.swap(m_Ready);
+    m_NumResumed = 0;
+
+    for (Behavior* pBehavior : m_Running)
+    {
+        pBehavior->m_bReady = false;
+        if (pBehavior->m_bStopped)
+        {
+            releaseIfUnused(pBehavior);
+            continue;
+        }
+
+        ++m_NumResumed;
+        const Behavior::Wait wait = pBehavior->resume(now);
+        Mob& mob = pBehavior->getMob();
+
+        if (wait.m_bDone)
+        {
+            mob.setBehavior(NULL);
+            mob.setWakeOn(0, 0.f);
+            pBehavior->m_bStopped = true;
+            releaseIfUnused(pBehavior);
+            continue;
+        }
+
+        assert(((wait.m_Until < FLT_MAX) || (wait.m_WakeOn != 0)) && "This behavior would never wake up!");
+        mob.setWakeOn(wait.m_WakeOn, wait.m_WakeRange);
+        pBehavior->m_DueTime = wait.m_Until;
+        if (wait.m_Until < FLT_MAX)
+        {
+            ++pBehavior->m_NumTimers;
+            m_Timers.schedule(wait.m_Until, pBehavior);
+        }
+    }
+
+    m_Running.clear();
+}
+
+void BehaviorScheduler::makeReady(Behavior* pBehavior)
+{
+    if (!pBehavior->m_bReady)
+    {
+        pBehavior->m_bReady = true;
+        m_Ready.push_back(pBehavior);
+    }
+}
+
+void BehaviorScheduler::onTimer(Behavior* pBehavior, float now)
+{
+    assert(pBehavior->m_NumTimers > 0);
+    --pBehavior->m_NumTimers;
+
+    if (pBehavior->m_bStopped)
+    {
+        releaseIfUnused(pBehavior);
+    }
+    else if (now >= pBehavior->m_DueTime)
+    {
+        // If it isn't due, this is a timer from an earlier wait, which was
+        // woken up some other way.
+        makeReady(pBehavior);
+    }
+}
+
+void BehaviorScheduler::releaseIfUnused(Behavior* pBehavior)
+{
+    // Stale timers still point at it, and so does the ready list, until 
+    // they've been dealt with.
+    if (!pBehavior->m_bStopped || (pBehavior->m_NumTimers > 0) || pBehavior->m_bReady)
+        return;
+
+    void* pFrame = pBehavior->m_pFrame;
+    pBehavior->~Behavior();
+    freeFrame(pFrame);
+}
+
+void* BehaviorScheduler::allocFrame()
+{
+    if (m_FreeFrames.empty())
+    {
+        Frame* pChunk = new Frame[ksFramesPerChunk];
+        m_Chunks.push_back(pChunk);
+
+        // Backwards, so that they're handed out in address order.
+        m_FreeFrames.reserve(m_Chunks.size() * ksFramesPerChunk);
+        for (size_t i = ksFramesPerChunk; i > 0; --i)
+        {
+            m_FreeFrames.push_back(&pChunk[i - 1]);
+        }
+    }
+
+    ++m_NumBehaviors;
+    void* pFrame = m_FreeFrames.back();
+    m_FreeFrames.pop_back();
+    return pFrame;
+}
+
+void BehaviorScheduler::freeFrame(void* pFrame)
+{
+    assert(m_NumBehaviors > 0);
+    --m_NumBehaviors;
+    m_FreeFrames.push_back(pFrame);
+}
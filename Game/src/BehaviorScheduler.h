@@ -0,0 +1,187 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "TimingWheel.h"
+
+#include <float.h>
+#include <new>
+#include <stddef.h>
+#include <type_traits>
+#include <vector>
+
+class Mob;
+class BehaviorScheduler;
+
+// A behavior that plays out over many ticks (like the Rogue's hide, spring
+// and recover), written as a resumable state machine.  Each call to 
+// resume() picks up from where the last one left off (in whatever state 
+// the subclass saved), runs until it has to wait for something, and 
+// returns what that is.  The BehaviorScheduler doesn't resume it again 
+// until that happens, so a behavior that's waiting costs nothing per tick.
+//   Behaviors only run between ticks (see Game::tick()), and only change 
+// their own mob.  Anything they want the mob to do while it ticks (how 
+// fast to move, whether to hang back...) they set on the mob.
+class Behavior : public iTimedEvent
+{
+public:
+    // Things that the mob can wake its behavior up for.  The mob checks 
+    // for these as it ticks (see Mob::tickAll()), but only the ones that 
+    // its behavior is actually waiting on.
+    enum WakeEvent
+    {
+        WakeOnTargetInRange = 1 << 0,   // our target is within Wait::m_WakeRange
+        WakeOnAttack        = 1 << 1,   // we attacked
+        WakeOnTargetLost    = 1 << 2,   // we're no longer locked on to a target
+    };
+
+    // What a behavior is waiting for.  Whichever of m_Until and m_WakeOn 
+    // happens first resumes it.
+    struct Wait
+    {
+        float m_Until;              // game time, or FLT_MAX for never
+        unsigned int m_WakeOn;      // WakeEvent bits
+        float m_WakeRange;          // for WakeOnTargetInRange
+        bool m_bDone;               // finished, don't resume again
+
+        static Wait until(float time) { Wait w = { time, 0, 0.f, false }; return w; }
+        static Wait wakeOn(unsigned int events, float range = 0.f) { Wait w = { FLT_MAX, events, range, false }; return w; }
+        static Wait done() { Wait w = { FLT_MAX, 0, 0.f, true }; return w; }
+
+        Wait& orUntil(float time) { m_Until = time; return *this; }
+    };
+
+    explicit Behavior(Mob& mob);
+    virtual ~Behavior() {}
+
+    // now is the current game time (in seconds).
+    virtual Wait resume(float now) = 0;
+
+    Mob& getMob() const { return m_Mob; }
+
+private:
+    friend class BehaviorScheduler;
+
+    // iTimedEvent
+    virtual void onTimer(float now);
+
+private:
+    Mob& m_Mob;
+    BehaviorScheduler* m_pScheduler;
+    void* m_pFrame;                 // where the scheduler built us
+
+    // When the wait we're in now times out (or FLT_MAX).  Timers from 
+    // earlier waits can still be in the wheel, so when one fires we check
+    // it against this.
+    float m_DueTime;
+    unsigned int m_NumTimers;       // ... and this is how many there are
+
+    bool m_bReady;                  // in the scheduler's ready list
+    bool m_bStopped;                // our mob has died
+
+private:
+    // DELIBERATELY UNDEFINED
+    Behavior(const Behavior& rhs);
+    Behavior& operator=(const Behavior& rhs);
+};
+
+// Owns the Behaviors and decides when they run.  Every behavior lives in a
+// fixed size frame from a pool, allocated in chunks that are never given 
+// back until the scheduler goes away, so starting one (after the first 
+// few) and resuming one never allocate.  Timed waits go on the Game's 
+// TimingWheel, and wake-ups come from the mobs (see wake()), so run() only
+// resumes the behaviors that are due.
+// NOTE: Behaviors shouldn't own anything.  The ones that are still running
+// when the scheduler goes away just go with their frames.
+class BehaviorScheduler
+{
+public:
+    // Big enough for any Behavior subclass (start() checks).
+    static const size_t ksFrameSize = 128;
+    static const size_t ksFramesPerChunk = 256;
+
+    explicit BehaviorScheduler(TimingWheel& timers);
+    ~BehaviorScheduler();
+
+    // Builds a T (which must derive from Behavior) for mob in a pooled 
+    // frame.  It's first resumed on the next run().
+    template <class T>
+    T* start(Mob& mob)
+    {
+        static_assert(std::is_base_of<Behavior, T>::value, "Behaviors must derive from Behavior");
+        static_assert(sizeof(T) <= ksFrameSize, "Behavior is too big for the frame pool - raise ksFrameSize");
+        static_assert(alignof(T) <= alignof(Frame), "Behavior needs more alignment than the frame pool gives");
+
+        void* pFrame = allocFrame();
+        T* pBehavior = new (pFrame) T(mob);
+        pBehavior->m_pScheduler = this;
+        pBehavior->m_pFrame = pFrame;
+        makeReady(pBehavior);
+        return pBehavior;
+    }
+
+    // The behavior's mob is dead, so it won't be resumed again.  Its frame
+    // goes back to the pool once nothing refers to it.
+    void stop(Behavior* pBehavior);
+
+    // Something that the behavior's wait asked for has happened (see 
+    // Behavior::WakeEvent).  It's resumed on the next run().
+    void wake(Behavior* pBehavior);
+
+    // Resume every behavior that's due, in the order they became due.
+    void run(float now);
+
+    size_t getNumBehaviors() const { return m_NumBehaviors; }
+    size_t getNumFrames() const { return m_Chunks.size() * ksFramesPerChunk; }
+
+    // How many behaviors the last run() resumed.
+    size_t getNumResumed() const { return m_NumResumed; }
+
+private:
+    friend class Behavior;
+
+    typedef std::aligned_storage<ksFrameSize, alignof(double)>::type Frame;
+
+    void makeReady(Behavior* pBehavior);
+    void onTimer(Behavior* pBehavior, float now);
+    void releaseIfUnused(Behavior* pBehavior);
+
+    void* allocFrame();
+    void freeFrame(void* pFrame);
+
+private:
+    TimingWheel& m_Timers;
+
+    std::vector<Frame*> m_Chunks;       // owned, ksFramesPerChunk frames each
+    std::vector<void*> m_FreeFrames;
+    size_t m_NumBehaviors;
+
+    std::vector<Behavior*> m_Ready;
+    std::vector<Behavior*> m_Running;   // scratch for run()
+    size_t m_NumResumed;
+
+private:
+    // DELIBERATELY UNDEFINED
+    BehaviorScheduler(const BehaviorScheduler& rhs);
+    BehaviorScheduler& operator=(const BehaviorScheduler& rhs);
+};
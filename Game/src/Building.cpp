@@ -22,8 +22,8 @@
 
 #include "Building.h"
 
-Building::Building(const iEntityStats& stats, const Vec2& pos, bool isNorth)
-    : Entity(stats, pos, isNorth)
+Building::Building(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth)
+    : Entity(game, stats, pos, isNorth)
 {
     assert(dynamic_cast<const iEntityStats_Building*>(&stats) != NULL);
 }
@@ -27,6 +27,6 @@
 class Building : public Entity 
 {
 public:
-    Building(const iEntityStats& stats, const Vec2& pos, bool isNorth);
+    Building(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth);
 };
 
@@ -0,0 +1,197 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "CollisionSolver.h"
+
+#include "Mob.h"
+
+#include <algorithm>
+
+// Pairs that are nearly touching are included too, since the relaxation 
+// passes move things around.
+static const float ksPairMargin = 0.25f;
+
+CollisionSolver::CollisionSolver(const ArenaLayout& layout)
+    : m_MaxRadius(0)
+    , m_ArenaWidth(layout.getWidth())
+    , m_ArenaHeight(layout.getHeight())
+{
+}
+
+void CollisionSolver::solve(const std::vector<Mob*>& mobs)
+{
+    m_Pairs.clear();
+    if (mobs.size() < 2)
+        return;
+
+    gather(mobs);
+    findPairs();
+    if (m_Pairs.empty())
+        return;
+
+    for (unsigned int i = 0; i < ksNumIterations; ++i)
+    {
+        relax();
+    }
+
+    scatter(mobs);
+}
+
+void CollisionSolver::gather(const std::vector<Mob*>& mobs)
+{
+    const size_t num = mobs.size();
+    m_X.resize(num);
+    m_Y.resize(num);
+    m_Radius.resize(num);
+    m_InvMass.resize(num);
+    m_MaxRadius = Real(0);
+
+    for (size_t i = 0; i < num; ++i)
+    {
+        const Mob& mob = *mobs[i];
+        const Vec2& pos = mob.getNextPosition();
+        m_X[i] = pos.x;
+        m_Y[i] = pos.y;
+        m_Radius[i] = Real(mob.getStats().getSize() / 2.f);
+        m_InvMass[i] = Real(1.f / mob.getStats().getMass());
+        m_MaxRadius = std::max(m_MaxRadius, m_Radius[i]);
+    }
+}
+
+void CollisionSolver::findPairs()
+{
+    const size_t num = m_X.size();
+
+    // Any pair that can touch is in the same or adjacent cells.
+    const Real cellSize = m_MaxRadius * Real(2) + Real(ksPairMargin);
+    const Real invCellSize = Real(1) / cellSize;
+    const int numCellsX = (int)(Real(m_ArenaWidth) * invCellSize) + 1;
+    const int numCellsY = (int)(Real(m_ArenaHeight) * invCellSize) + 1;
+    const int numCells = numCellsX * numCellsY;
+
+    // Counting sort of the mobs by cell.
+    m_Cell.resize(num);
+    m_CellStart.assign(numCells + 1, 0);
+    for (size_t i = 0; i < num; ++i)
+    {
+        const int cx = std::min(std::max((int)(m_X[i] * invCellSize), 0), numCellsX - 1);
+        const int cy = std::min(std::max((int)(m_Y[i] * invCellSize), 0), numCellsY - 1);
+        m_Cell[i] = (uint32_t)(cy * numCellsX + cx);
+        ++m_CellStart[m_Cell[i] + 1];
+    }
+    for (int c = 0; c < numCells; ++c)
+    {
+        m_CellStart[c + 1] += m_CellStart[c];
+    }
+
+    m_Sorted.resize(num);
+    m_Cursor.assign(m_CellStart.begin(), m_CellStart.end() - 1);
+    for (size_t i = 0; i < num; ++i)
+    {
+        m_Sorted[m_Cursor[m_Cell[i]]++] = (uint32_t)i;
+    }
+
+    // Each mob checks its own cell and the ones around it, and takes the 
+    // pairs where it has the lower index, so each pair is found once (and
+    // always in the same order).
+    for (size_t i = 0; i < num; ++i)
+    {
+        const int cx = (int)(m_Cell[i] % numCellsX);
+        const int cy = (int)(m_Cell[i] / numCellsX);
+
+        for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, numCellsY - 1); ++y)
+        {
+            for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, numCellsX - 1); ++x)
+            {
+                const int c = y * numCellsX + x;
+                for (uint32_t s = m_CellStart[c]; s < m_CellStart[c + 1]; ++s)
+                {
+                    const uint32_t j = m_Sorted[s];
+                    if (j <= i)
+                        continue;
+
+                    const Real reach = m_Radius[i] + m_Radius[j] + Real(ksPairMargin);
+                    const Real dx = m_X[j] - m_X[i];
+                    const Real dy = m_Y[j] - m_Y[i];
+                    if (dx * dx + dy * dy >= reach * reach)
+                        continue;
+
+                    Pair p;
+                    p.m_A = (uint32_t)i;
+                    p.m_B = j;
+                    p.m_MinDist = m_Radius[i] + m_Radius[j];
+                    const Real totalInvMass = m_InvMass[i] + m_InvMass[j];
+                    p.m_WeightA = m_InvMass[i] / totalInvMass;
+                    p.m_WeightB = m_InvMass[j] / totalInvMass;
+                    m_Pairs.push_back(p);
+                }
+            }
+        }
+    }
+}
+
+void CollisionSolver::relax()
+{
+    for (const Pair& p : m_Pairs)
+    {
+        Real dx = m_X[p.m_B] - m_X[p.m_A];
+        Real dy = m_Y[p.m_B] - m_Y[p.m_A];
+        const Real distSq = dx * dx + dy * dy;
+        if (distSq >= p.m_MinDist * p.m_MinDist)
+            continue;
+
+        // If they're exactly on top of each other then there's no direction
+        // to push them in, so just pick one (along x, a unit vector), and 
+        // push them the whole way apart.
+        const Real dist = sqrt(distSq);
+        Real push;
+        if (dist <= Real(0))
+        {
+            dx = Real(1);
+            dy = Real(0);
+            push = p.m_MinDist;
+        }
+        else
+        {
+            push = (p.m_MinDist - dist) / dist;
+        }
+
+        const Real pushX = dx * push;
+        const Real pushY = dy * push;
+        m_X[p.m_A] -= pushX * p.m_WeightA;
+        m_Y[p.m_A] -= pushY * p.m_WeightA;
+        m_X[p.m_B] += pushX * p.m_WeightB;
+        m_Y[p.m_B] += pushY * p.m_WeightB;
+    }
+}
+
+void CollisionSolver::scatter(const std::vector<Mob*>& mobs)
+{
+    // Don't push anyone off the edge of the arena.
+    for (size_t i = 0; i < mobs.size(); ++i)
+    {
+        const Real r = m_Radius[i];
+        const Real x = std::min(std::max(m_X[i], r), Real(m_ArenaWidth) - r);
+        const Real y = std::min(std::max(m_Y[i], r), Real(m_ArenaHeight) - r);
+        mobs[i]->setNextPosition(Vec2(x, y));
+    }
+}
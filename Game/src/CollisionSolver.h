@@ -0,0 +1,95 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "Vec2.h"
+
+#include <stdint.h>
+#include <vector>
+
+class Mob;
+
+// Pushes overlapping mobs apart.  Each mob is a circle (sized from 
+// getSize()), and when two overlap they're pushed apart along the line 
+// between them, the lighter one moving further (by getMass()).  
+//
+// It works on the mobs' next positions (after they've moved this tick, 
+// before they're committed).  We find the pairs that are close enough to 
+// matter once, with a uniform grid, and then relax them a fixed number of
+// times - fixing one pair can push a mob into another, and the extra passes
+// let that settle.  The mobs are copied into flat arrays first, so the 
+// passes don't chase pointers.
+// NOTE: This runs on one thread, in a fixed order, so it's deterministic.
+class CollisionSolver
+{
+public:
+    static const unsigned int ksNumIterations = 4;
+
+    explicit CollisionSolver(const ArenaLayout& layout);
+
+    void solve(const std::vector<Mob*>& mobs);
+
+    size_t getNumPairs() const { return m_Pairs.size(); }
+
+private:
+    struct Pair
+    {
+        uint32_t m_A;
+        uint32_t m_B;
+        Real m_MinDist;         // sum of the radii
+        Real m_WeightA;         // share of the push that A takes
+        Real m_WeightB;
+    };
+
+    void gather(const std::vector<Mob*>& mobs);
+    void findPairs();
+    void relax();
+    void scatter(const std::vector<Mob*>& mobs);
+
+private:
+    // One entry per mob, in the order we were given them.
+    std::vector<Real> m_X;
+    std::vector<Real> m_Y;
+    std::vector<Real> m_Radius;
+    std::vector<Real> m_InvMass;
+    Real m_MaxRadius;
+
+    int m_ArenaWidth;
+    int m_ArenaHeight;
+
+    // The broadphase grid.  m_Sorted holds the mob indices ordered by cell,
+    // and cell c's mobs are m_Sorted[m_CellStart[c]] up to 
+    // m_Sorted[m_CellStart[c + 1]].
+    std::vector<uint32_t> m_Cell;
+    std::vector<uint32_t> m_CellStart;
+    std::vector<uint32_t> m_Sorted;
+    std::vector<uint32_t> m_Cursor;         // scratch for the sort
+
+    std::vector<Pair> m_Pairs;
+
+private:
+    // DELIBERATELY UNDEFINED
+    CollisionSolver(const CollisionSolver& rhs);
+    CollisionSolver& operator=(const CollisionSolver& rhs);
+};
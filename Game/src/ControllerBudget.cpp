@@ -0,0 +1,118 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ControllerBudget.h"
+
+#include <algorithm>
+#include <string.h>
+
+ControllerBudget::ControllerBudget()
+    : m_NumTicks(0)
+    , m_NumSkipped(0)
+    , m_TotalSec(0.)
+    , m_MaxSec(0.f)
+    , m_DebtSec(0.f)
+    , m_bForfeited(false)
+    , m_NumThinks(0)
+    , m_ThinkOfferedSec(0.)
+    , m_ThinkUsedSec(0.)
+    , m_MaxThinkOverrunSec(0.f)
+{
+    memset(m_Histogram, 0, sizeof(m_Histogram));
+}
+
+bool ControllerBudget::shouldTick()
+{
+    if (m_bForfeited)
+        return false;
+
+    if ((m_DebtSec > 0.f) && (m_Settings.m_TickBudgetSec > 0.f))
+    {
+        // Each tick we sit out pays back one tick's worth of budget.
+        m_DebtSec -= m_Settings.m_TickBudgetSec;
+        ++m_NumSkipped;
+        return false;
+    }
+
+    return true;
+}
+
+void ControllerBudget::record(float elapsedSec)
+{
+    ++m_NumTicks;
+    m_TotalSec += elapsedSec;
+    m_MaxSec = std::max(m_MaxSec, elapsedSec);
+
+    const unsigned int us = (unsigned int)std::min(elapsedSec * 1e6f, 4e9f);
+    int bucket = 0;
+    while ((bucket < ksNumBuckets - 1) && ((us >> bucket) != 0))
+    {
+        ++bucket;
+    }
+    ++m_Histogram[bucket];
+
+    if ((m_Settings.m_TickBudgetSec > 0.f) && (elapsedSec > m_Settings.m_TickBudgetSec))
+    {
+        m_DebtSec += elapsedSec - m_Settings.m_TickBudgetSec;
+    }
+
+    if ((m_Settings.m_MatchBudgetSec > 0.f) && (m_TotalSec > m_Settings.m_MatchBudgetSec))
+    {
+        m_bForfeited = true;
+    }
+}
+
+void ControllerBudget::recordThink(float offeredSec, float usedSec)
+{
+    ++m_NumThinks;
+    m_ThinkOfferedSec += offeredSec;
+    m_ThinkUsedSec += usedSec;
+    m_MaxThinkOverrunSec = std::max(m_MaxThinkOverrunSec, usedSec - offeredSec);
+}
+
+void ControllerBudget::print(std::ostream& out, const char* name) const
+{
+    const double avgUs = m_NumTicks ? (m_TotalSec * 1e6 / m_NumTicks) : 0.;
+    out << name << ": " << m_NumTicks << " ticks, " << m_NumSkipped << " skipped, "
+        << m_TotalSec * 1e3 << "ms total, " << avgUs << "us avg, " 
+        << m_MaxSec * 1e6f << "us max" << (m_bForfeited ? " (FORFEITED)" : "") << "\n";
+
+    if (m_NumThinks > 0)
+    {
+        const double usedPct = (m_ThinkOfferedSec > 0.) ? (100. * m_ThinkUsedSec / m_ThinkOfferedSec) : 0.;
+        out << "    idle time: " << m_NumThinks << " thinks, " << m_ThinkUsedSec * 1e3 << "ms used of "
+            << m_ThinkOfferedSec * 1e3 << "ms offered (" << usedPct << "%), " 
+            << m_MaxThinkOverrunSec * 1e6f << "us max overrun\n";
+    }
+
+    // Only print the buckets that are in use.
+    int first = 0;
+    int last = ksNumBuckets - 1;
+    while ((first < last) && (m_Histogram[first] == 0)) ++first;
+    while ((last > first) && (m_Histogram[last] == 0)) --last;
+
+    for (int i = first; i <= last; ++i)
+    {
+        const unsigned int lo = (i == 0) ? 0 : (1u << (i - 1));
+        out << "    " << lo << "us+\t" << m_Histogram[i] << "\n";
+    }
+}
@@ -0,0 +1,97 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <ostream>
+
+// Keeps track of how long a controller spends in tick(), and enforces its 
+// time budgets.  A controller that runs long on a tick pays for it by 
+// sitting out later ticks until it has made up the time, and one that uses
+// up its whole match budget forfeits.
+// NOTE: Timing depends on the machine, so as soon as a budget is set the
+// results of a match are no longer reproducible.  Both are off by default.
+class ControllerBudget
+{
+public:
+    struct Settings
+    {
+        float m_TickBudgetSec;      // 0 => unlimited
+        float m_MatchBudgetSec;     // 0 => unlimited
+
+        Settings() : m_TickBudgetSec(0.f), m_MatchBudgetSec(0.f) {}
+    };
+
+    // Bucket 0 counts ticks that took under 1us, and bucket i counts ticks
+    // that took [2^(i-1), 2^i) us.  The last bucket also gets anything longer.
+    static const int ksNumBuckets = 24;
+
+    ControllerBudget();
+
+    void setSettings(const Settings& settings) { m_Settings = settings; }
+    const Settings& getSettings() const { return m_Settings; }
+
+    // Should the controller get to tick this time?  If not, this counts as a
+    // skipped tick.
+    bool shouldTick();
+
+    // Record how long the controller's tick took.
+    void record(float elapsedSec);
+
+    // Record a call to think(): how much idle time we offered it, and how 
+    // long it actually took (which may be more, if it overran).  This 
+    // doesn't count against the budgets.
+    void recordThink(float offeredSec, float usedSec);
+
+    bool hasForfeited() const { return m_bForfeited; }
+
+    unsigned int getNumTicks() const { return m_NumTicks; }
+    unsigned int getNumSkipped() const { return m_NumSkipped; }
+    float getTotalSec() const { return (float)m_TotalSec; }
+    float getMaxSec() const { return m_MaxSec; }
+    unsigned int getBucket(int i) const { return m_Histogram[i]; }
+
+    unsigned int getNumThinks() const { return m_NumThinks; }
+    float getThinkOfferedSec() const { return (float)m_ThinkOfferedSec; }
+    float getThinkUsedSec() const { return (float)m_ThinkUsedSec; }
+    float getMaxThinkOverrunSec() const { return m_MaxThinkOverrunSec; }
+
+    // A human readable summary, with the histogram.
+    void print(std::ostream& out, const char* name) const;
+
+private:
+    Settings m_Settings;
+
+    unsigned int m_NumTicks;
+    unsigned int m_NumSkipped;
+    double m_TotalSec;
+    float m_MaxSec;
+    float m_DebtSec;                // time still to be paid back by skipping
+    bool m_bForfeited;
+
+    unsigned int m_NumThinks;
+    double m_ThinkOfferedSec;
+    double m_ThinkUsedSec;
+    float m_MaxThinkOverrunSec;
+
+    unsigned int m_Histogram[ksNumBuckets];
+};
@@ -0,0 +1,148 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Controller_Async.h"
+
+#include "iPlayer.h"
+
+#include <algorithm>
+#include <string.h>
+
+// Enough for a controller to place a mob every tick for a long while.
+static const size_t ksCommandQueueSize = 256;
+
+Controller_Async::Controller_Async(iController* pControl)
+    : m_pControl(pControl)
+    , m_bBusy(false)
+    , m_Commands(ksCommandQueueSize)
+    , m_bQuit(false)
+    , m_NumThinks(0)
+    , m_NumDropped(0)
+    , m_Tick(0)
+    , m_Time(0.f)
+    , m_UnsentDeltaTSec(0.f)
+{
+    assert(m_pControl);
+    memset(&m_Stats, 0, sizeof(m_Stats));
+
+    m_pControl->setPlayer(m_View);
+    m_Thread = std::thread(&Controller_Async::workerMain, this);
+}
+
+Controller_Async::~Controller_Async()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeLock);
+        m_bQuit = true;
+    }
+    m_WakeCond.notify_one();
+    m_Thread.join();
+
+    delete m_pControl;
+}
+
+void Controller_Async::tick(float deltaTSec)
+{
+    assert(m_pPlayer);
+
+    ++m_Tick;
+    m_Time += deltaTSec;
+    m_UnsentDeltaTSec += deltaTSec;
+    m_TickTimes.push_back(m_Time);
+
+    // Check whether the worker is idle *before* we drain the queue, so that 
+    // anything it queued before going idle is applied before we hand it the
+    // next snapshot (which will then reflect those placements).
+    const bool bIdle = !m_bBusy.load(std::memory_order_acquire);
+    applyCommands();
+
+    if (!bIdle)
+    {
+        ++m_Stats.m_NumBusyTicks;
+        return;
+    }
+
+    m_Pending.capture(*m_pPlayer, m_Tick, m_UnsentDeltaTSec);
+    m_UnsentDeltaTSec = 0.f;
+
+    // Only ticks from this snapshot on can have placements still to come.
+    m_TickTimes.erase(m_TickTimes.begin(), m_TickTimes.end() - 1);
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeLock);
+        m_bBusy.store(true, std::memory_order_release);
+    }
+    m_WakeCond.notify_one();
+}
+
+Controller_Async::Stats Controller_Async::getStats() const
+{
+    Stats stats = m_Stats;
+    stats.m_NumThinks = m_NumThinks.load(std::memory_order_relaxed);
+    stats.m_NumDropped = m_NumDropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Controller_Async::applyCommands()
+{
+    Command cmd;
+    while (m_Commands.pop(cmd))
+    {
+        m_pPlayer->placeMob(cmd.m_Type, cmd.m_Pos);
+
+        const unsigned int latencyTicks = m_Tick - cmd.m_Tick;
+        const size_t age = std::min((size_t)latencyTicks, m_TickTimes.size() - 1);
+        const float latencySec = m_Time - m_TickTimes[m_TickTimes.size() - 1 - age];
+
+        ++m_Stats.m_NumPlacements;
+        m_Stats.m_TotalLatencyTicks += latencyTicks;
+        m_Stats.m_MaxLatencyTicks = std::max(m_Stats.m_MaxLatencyTicks, latencyTicks);
+        m_Stats.m_TotalLatencySec += latencySec;
+        m_Stats.m_MaxLatencySec = std::max(m_Stats.m_MaxLatencySec, latencySec);
+    }
+}
+
+void Controller_Async::workerMain()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_WakeLock);
+            m_WakeCond.wait(lock, [this]() { return m_bQuit || m_bBusy.load(std::memory_order_acquire); });
+            if (m_bQuit)
+                return;
+        }
+
+        m_View.swap(m_Pending);
+        m_pControl->tick(m_View.getDeltaTSec());
+
+        for (const PlayerSnapshot::Placement& p : m_View.getPlacements())
+        {
+            Command cmd = { m_View.getTick(), p.m_Type, p.m_Pos };
+            if (!m_Commands.push(cmd))
+                m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        m_NumThinks.fetch_add(1, std::memory_order_relaxed);
+        m_bBusy.store(false, std::memory_order_release);
+    }
+}
@@ -0,0 +1,106 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "iController.h"
+#include "PlayerSnapshot.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs another controller on its own thread, so that it can think for as 
+// long as it likes without holding up the game.
+//
+// Each tick, if the controller has finished thinking, we hand it a fresh 
+// PlayerSnapshot and wake it up.  Its placements come back through a 
+// lock-free queue, stamped with the tick of the snapshot they were decided
+// on, and are made at the start of our next tick.  While it's still 
+// thinking, the game carries on without it.
+// NOTE: The results depend on thread timing, so matches with an async 
+// controller aren't reproducible.
+class Controller_Async : public iController
+{
+public:
+    // NOTE: we take ownership of pControl.
+    explicit Controller_Async(iController* pControl);
+    virtual ~Controller_Async();
+
+    void tick(float deltaTSec);
+
+    // How long it takes for decisions to reach the game.  Latency is 
+    // measured from the tick of the snapshot to the tick the placement was
+    // made.
+    struct Stats
+    {
+        unsigned int m_NumThinks;           // snapshots the controller has finished
+        unsigned int m_NumBusyTicks;        // ticks where it was still thinking
+        unsigned int m_NumPlacements;
+        unsigned int m_NumDropped;          // the queue was full
+        unsigned long long m_TotalLatencyTicks;
+        unsigned int m_MaxLatencyTicks;
+        double m_TotalLatencySec;           // in game time
+        float m_MaxLatencySec;
+    };
+    Stats getStats() const;
+
+private:
+    struct Command
+    {
+        unsigned int m_Tick;
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
+    void workerMain();
+    void applyCommands();
+
+private:
+    iController* m_pControl;            // owned, runs on m_Thread
+
+    // The game thread captures into m_Pending while m_bBusy is false, then 
+    // sets it.  The worker swaps m_Pending into m_View (the snapshot the 
+    // controller sees), thinks, queues its placements and clears m_bBusy.
+    PlayerSnapshot m_Pending;
+    PlayerSnapshot m_View;
+    std::atomic<bool> m_bBusy;
+    SpscQueue<Command> m_Commands;
+
+    std::mutex m_WakeLock;
+    std::condition_variable m_WakeCond;
+    bool m_bQuit;
+    std::thread m_Thread;
+
+    // Worker thread stats.
+    std::atomic<unsigned int> m_NumThinks;
+    std::atomic<unsigned int> m_NumDropped;
+
+    // Game thread only.
+    unsigned int m_Tick;
+    float m_Time;
+    float m_UnsentDeltaTSec;            // game time since the last snapshot we handed over
+    std::vector<float> m_TickTimes;     // the game time of recent ticks, for latency in seconds
+    Stats m_Stats;
+};
@@ -22,12 +22,15 @@
 
 #include "Building.h"
 #include "Constants.h"
+#include "Controller_AI_KevinDill.h"
+#include "Controller_AI_MCTS.h"
 #include "Controller_UI.h"
 #include "Game.h"
 #include "Graphics.h"
 #include "Player.h"
 
 #include <chrono>
+#include <thread>
 
 bool init() {
     return true;
@@ -42,7 +45,16 @@ void close() {
 }
 
 int main(int argc, char* args[]) {
-    Game& game = Game::get();
+    // FinalProject: This is where you specify which controllers to use - for 
+    // instance, if you make two instances of your AI then it will play 
+    // itself, or if you make one the UI and one your AI then you can play
+    // against your AI.  If you make the controller NULL then that player
+    // will just passively sit there and let you kill it.  If your AI needs
+    // to think for longer than a frame, wrap it in a Controller_Async (e.g.
+    // new Controller_Async(new Controller_AI_KevinDill)) and it will think on
+    // its own thread while the game carries on.  For an opponent that
+    // plans by searching ahead, try new Controller_AI_MCTS.
+    Game game(new Controller_AI_KevinDill, new Controller_UI);
     Graphics& graphics = Graphics::get();
 
     //Start up SDL and create window
@@ -51,13 +63,13 @@ int main(int argc, char* args[]) {
     }
     else {
         using namespace std::chrono;
-        high_resolution_clock::time_point prevTime = high_resolution_clock::now();
+        steady_clock::time_point prevTime = steady_clock::now();
 
         bool quit = false;
         SDL_Event e;
         while (!quit) {
             // Get the elapsed time, and ensure it's at between TICK_MIN and TICK_MAX
-            high_resolution_clock::time_point now = high_resolution_clock::now();
+            steady_clock::time_point now = steady_clock::now();
             double deltaTSec = (float)duration_cast<milliseconds>(now - prevTime).count() / 1000;
 
             if (deltaTSec > TICK_MAX)
@@ -67,7 +79,15 @@ int main(int argc, char* args[]) {
             }
 
             if (deltaTSec < TICK_MIN)
+            {
+                // Rather than spinning until it's time for the next tick,
+                // give the spare time to the controllers, and then sleep 
+                // through whatever they didn't use.
+                const steady_clock::time_point nextTick = prevTime + duration_cast<steady_clock::duration>(duration<float>(TICK_MIN));
+                game.think(nextTick);
+                std::this_thread::sleep_until(nextTick);
                 continue;
+            }
 
             prevTime = now;
 
@@ -108,6 +128,8 @@ int main(int argc, char* args[]) {
                 }
             }
 
+            graphics.drawProjectiles(game.getProjectiles());
+
             // Draw the elixir values:
             graphics.drawElixir(northPlayer.getElixir(), southPlayer.getElixir());
 
@@ -119,6 +141,8 @@ int main(int argc, char* args[]) {
 
     }
 
+    game.printControllerStats(std::cout);
+
     close();
     return 0;
 }
@@ -27,41 +27,93 @@
 #include "Mob.h"
 #include "Player.h"
 
-Entity::Entity(const iEntityStats& stats, const Vec2& pos, bool isNorth)
-    : m_Stats(stats)
+#include <string.h>
+
+Entity::Entity(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth)
+    : m_Game(game)
+    , m_Stats(stats)
+    , m_Id(game.allocateEntityId())
     , m_bNorth(isNorth)
     , m_Health(stats.getMaxHealth())
     , m_Pos(pos)
     , m_pTarget(NULL)
     , m_bTargetLock(NULL)
-    , m_TimeSinceAttack(0.f)
+    , m_bAttackReady(false)
+    , m_AttackDamage(stats.getDamage())
+    , m_StateHash(0)
+    , m_bHashDirty(true)
 {
+    scheduleNextAttack();
 }
 
-void Entity::tick(float deltaTSec)
+void Entity::tick(float /*deltaTSec*/, IntentBuffer& intents)
 {
-    // Project 2: You may need to do something special here to change the way the Rogue
-    // does damage, or how much damage it does (among other things).
-
     pickTarget();
-    m_TimeSinceAttack += deltaTSec;
-    if (targetInRange() && (m_TimeSinceAttack > m_Stats.getAttackTime()))
+    if (m_bAttackReady && targetInRange())
     {
-        char buff[200];
-        snprintf(buff, 200, "%s %s attacks %s %s for %d damage.\n",
-                 m_bNorth ? "North" : "South",
-                 m_Stats.getName(),
-                 m_pTarget->isNorth() ? "North" : "South",
-                 m_pTarget->getStats().getName(),
-                 m_Stats.getDamage());
-        std::cout << buff;
-
-        m_bTargetLock = true;
-        m_pTarget->takeDamage(m_Stats.getDamage());
-        m_TimeSinceAttack = 0.f;
+        attack(intents);
     }
 }
 
+// The bits of a Real, so that the hash sees every change, however small.
+static uint64_t getBits(Real value)
+{
+#ifdef CRASHLOYAL_FIXED_POINT
+    return (uint64_t)value.getRaw();
+#else
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+#endif
+}
+
+// splitmix64's finalizer.  Every bit of the input affects every bit of the
+// output, so XORing lots of these together doesn't cancel out.
+static uint64_t mixHash(uint64_t h)
+{
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+uint64_t Entity::refreshStateHash()
+{
+    if (!m_bHashDirty)
+        return 0;
+    m_bHashDirty = false;
+
+    uint64_t hash = 0;
+    if (!isDead())
+    {
+        hash = mixHash(m_Id);
+        hash = mixHash(hash ^ getBits(m_Pos.x));
+        hash = mixHash(hash ^ (getBits(m_Pos.y) << 1));
+        hash = mixHash(hash ^ (uint32_t)m_Health);
+        hash = mixHash(hash ^ (m_pTarget ? m_pTarget->getId() : 0xFFFFFFFFull));
+    }
+
+    const uint64_t change = m_StateHash ^ hash;
+    m_StateHash = hash;
+    return change;
+}
+
+void Entity::scheduleNextAttack()
+{
+    m_bAttackReady = false;
+    m_Game.getTimers().schedule(m_Game.getTime() + m_Stats.getAttackTime(), this);
+}
+
+void Entity::attack(IntentBuffer& intents)
+{
+    assert(m_bAttackReady && !!m_pTarget);
+
+    // The damage (and the timer for our next attack) is applied by 
+    //  Game::resolveIntents(), once everyone has had a chance to act.
+    m_bTargetLock = true;
+    m_bAttackReady = false;
+    intents.pushDamage(this, m_pTarget, m_AttackDamage);
+}
+
 void Entity::pickTarget()
 {
     assert(!m_bTargetLock || !!m_pTarget);
@@ -70,16 +122,15 @@ void Entity::pickTarget()
         return;
     }
 
+    const Entity* pOldTarget = m_pTarget;
     m_pTarget = NULL;
     m_bTargetLock = false;
 
-    Game& game = Game::get();
-
     // we only attack things that are within our sight radius
-    float closestDist = getStats().getSightRadius();
-    float closestDistSq = closestDist * closestDist;
+    Real closestDist = getStats().getSightRadius();
+    Real closestDistSq = closestDist * closestDist;
 
-    Player& opposingPlayer = Game::get().getPlayer(!m_bNorth);
+    Player& opposingPlayer = m_Game.getPlayer(!m_bNorth);
 
 
     if (m_Stats.getTargetType() != iEntityStats::Mob)
@@ -89,7 +140,7 @@ void Entity::pickTarget()
             assert(pEntity->isNorth() != isNorth());
             if (!pEntity->isDead())
             {
-                float distSq = m_Pos.distSqr(pEntity->getPosition());
+                Real distSq = m_Pos.distSqr(pEntity->getPosition());
                 if (distSq < closestDistSq)
                 {
                     closestDistSq = distSq;
@@ -104,9 +155,9 @@ void Entity::pickTarget()
         for (Entity* pEntity : opposingPlayer.getMobs())
         {
             assert(pEntity->isNorth() != isNorth());
-            if (!pEntity->isDead())
+            if (!pEntity->isDead() && !pEntity->isHidden())
             {
-                float distSq = m_Pos.distSqr(pEntity->getPosition());
+                Real distSq = m_Pos.distSqr(pEntity->getPosition());
                 if (distSq < closestDistSq)
                 {
                     closestDistSq = distSq;
@@ -115,13 +166,18 @@ void Entity::pickTarget()
             }
         }
     }
+
+    if (m_pTarget != pOldTarget)
+    {
+        markHashDirty();
+    }
 }
 
 bool Entity::targetInRange()
 {
     if (!!m_pTarget)
     {
-        float range = m_Stats.getAttackRange();
+        Real range = m_Stats.getAttackRange();
 
         if (m_Stats.getDamageType() == iEntityStats::Melee)
         {
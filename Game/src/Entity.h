@@ -23,40 +23,84 @@
 #pragma once
 
 #include "EntityStats.h"
+#include "IntentBuffer.h"
 #include "iPlayer.h"
+#include "TimingWheel.h"
 #include "Vec2.h"
 
-class Entity 
+#include <stdint.h>
+
+class Game;
+
+class Entity : public iTimedEvent
 {
 
 public:
-    Entity(const iEntityStats& stats, const Vec2& pos, bool isNorth);
+    Entity(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth);
     virtual ~Entity() {}
 
     virtual const iEntityStats& getStats() const { return m_Stats; }
 
-    virtual void tick(float deltaTSec);
+    // Unique for the life of the Game, and assigned in spawn order.  Use this
+    // (rather than pointers) whenever something needs a deterministic order.
+    unsigned int getId() const { return m_Id; }
+
+    // Ticking is done in two phases.  First every entity ticks, reading only
+    // the state from the end of the previous tick and pushing anything it 
+    // does to other entities into intents.  Then, once everyone has ticked,
+    // the Game applies the intents and calls commit() to apply our own
+    // pending changes.
+    virtual void tick(float deltaTSec, IntentBuffer& intents);
+    virtual void commit() {}
 
     virtual bool isNorth() const { return m_bNorth; }
 
     virtual bool isDead() const { return m_Health <= 0; }
     virtual int getHealth() const { return m_Health; }
-    void takeDamage(int dmg) { m_Health -= dmg; }
+    void takeDamage(int dmg) { m_Health -= dmg; markHashDirty(); }
+    void setHealth(int health) { m_Health = health; markHashDirty(); }
 
     virtual const Vec2& getPosition() const { return m_Pos; }
 
     // Hidden entities will appear faded if they belong to the South player, and will
-    // not be rendered at all if they belong to the North player.
+    // not be rendered at all if they belong to the North player.  They can't
+    // be targeted, either.
     virtual bool isHidden() const { return false; }
 
+    // Whether we've attacked our target, and so are sticking with it.
+    bool hasTargetLock() const { return m_bTargetLock; }
+
+    // How much damage our attacks do.  Starts as our stats say, but a 
+    // behavior can change it (like the Rogue's spring attack).
+    int getAttackDamage() const { return m_AttackDamage; }
+    void setAttackDamage(int damage) { m_AttackDamage = damage; }
+
     iPlayer::EntityData getData() const { return iPlayer::EntityData(m_Stats, m_Health, m_Pos); }
 
+    // Our part of Game::getStateHash(): a hash of our id, position, health 
+    // and target, or 0 once we're dead.  Anything that changes one of those
+    // calls markHashDirty(), and the Game calls refreshStateHash() at the 
+    // end of the tick, which returns the old hash XORed with the new one.
+    uint64_t getStateHash() const { return m_StateHash; }
+    void markHashDirty() { m_bHashDirty = true; }
+    uint64_t refreshStateHash();
+
+    // What we've added to our Player's InfluenceMap.
+    InfluenceMap::Stamp& getInfluenceStamp() { return m_InfluenceStamp; }
+
+    // iTimedEvent - called by the Game's TimingWheel when our attack is ready.
+    virtual void onTimer(float /*now*/) { m_bAttackReady = true; }
+    void scheduleNextAttack();
+
 protected:
     void pickTarget();
     bool targetInRange();
+    void attack(IntentBuffer& intents);
 
 protected:
+    Game& m_Game;
     const iEntityStats& m_Stats;
+    unsigned int m_Id;
     bool m_bNorth;
     int m_Health;
     Vec2 m_Pos;
@@ -66,5 +110,14 @@ protected:
     //  it dies
     Entity* m_pTarget;
     bool m_bTargetLock;
-    float m_TimeSinceAttack;
+
+    // Rather than counting up the time since our last attack every tick, we 
+    //  schedule a timer for when the next attack will be ready.
+    bool m_bAttackReady;
+    int m_AttackDamage;
+
+    uint64_t m_StateHash;
+    bool m_bHashDirty;
+
+    InfluenceMap::Stamp m_InfluenceStamp;
 };
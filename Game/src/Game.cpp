@@ -22,43 +22,433 @@
 
 #include "Game.h"
 
+#include <algorithm>
 #include <cmath>
 #include "Building.h"
 #include "Constants.h"
-#include "Controller_UI.h"
-#include "Controller_AI_KevinDill.h"
+#include "JobSystem.h"
 #include "Mob.h"
+#include "MobBehavior.h"
 #include "Player.h"
 
-Game* Singleton<Game>::s_Obj = NULL;
+// Each job ticks this many entities.  Big enough that the per-job overhead
+// is lost in the noise, small enough that stealing can balance the load.
+static const size_t ksEntitiesPerJob = 64;
 
-Game::Game()
-    : gameOverState(0) // No winner at start of game
+Game::Game(iController* pNorthControl, iController* pSouthControl, unsigned int numThreads,
+           const ArenaLayout& layout)
+    : m_Layout(layout)
+    , m_Time(0.f)
+    , m_Timers(TICK_MIN)
+    , m_Behaviors(m_Timers)
+    , m_NumThinks(0)
+    , m_NextEntityId(0)
+    , m_pJobs(NULL)
+    , m_MobGrid(layout)
+    , m_Collisions(layout)
+    , m_Arena(layout)
+    , m_NumStandingTowers(0)
+    , m_StateHash(0)
+    , m_bLogging(true)
+    , gameOverState(0) // No winner at start of game
 {
-    // FinalProject: This is where you specify which controllers to use - for 
-    // instance, if you make two instances of your AI then it will play 
-    // itself, or if you make one the UI and one your AI then you can play
-    // against your AI.  If you make the controller NULL then that player
-    // will just passively sit there and let you kill it.
-    buildPlayers(new Controller_AI_KevinDill, new Controller_UI);
+    setNumThreads(numThreads);
+    buildPlayers(pNorthControl, pSouthControl);
 
     buildWaypoints();
+    updateArena();
+    updateStateHash();
+    m_pNorthPlayer->updateInfluence();
+    m_pSouthPlayer->updateInfluence();
 }
 
 Game::~Game()
 {
     delete m_pNorthPlayer;
     delete m_pSouthPlayer;
+    delete m_pJobs;
+}
+
+void Game::setNumThreads(unsigned int numThreads)
+{
+    delete m_pJobs;
+    m_pJobs = new JobSystem(numThreads);
+    m_Intents.resize(m_pJobs->getNumThreads());
+}
+
+unsigned int Game::getNumThreads() const
+{
+    return m_pJobs->getNumThreads();
 }
 
 void Game::tick(float deltaTSec)
 {
-    m_pNorthPlayer->tick(deltaTSec);
-    m_pSouthPlayer->tick(deltaTSec);
+    // Wake up anything whose timer has expired before the players tick, so
+    // that (for example) attacks that are ready can happen this tick.
+    m_Time += deltaTSec;
+    m_Timers.advance(m_Time);
+
+    m_pNorthPlayer->tickController(deltaTSec);
+    m_pSouthPlayer->tickController(deltaTSec);
+
+    // Queued placements go down once both sides have had their say, so 
+    // neither sees the other's before it's made its own.
+    m_pNorthPlayer->applyPlacements();
+    m_pSouthPlayer->applyPlacements();
+
+    // Behaviors that are due (including those of the mobs that were just 
+    // placed) decide what their mobs do this tick.
+    m_Behaviors.run(m_Time);
+
+    // Everyone acts on the state from the end of the last tick...
+    tickEntities(deltaTSec);
+    landProjectiles(deltaTSec);
+
+    // ... and then we apply the results all at once.
+    resolveIntents();
+
+    m_pNorthPlayer->removeDeadMobs();
+    m_pSouthPlayer->removeDeadMobs();
+
+    // The controllers' queries see the mobs as they are now.
+    m_pNorthPlayer->buildMobIndex();
+    m_pSouthPlayer->buildMobIndex();
+
+    updateVisibility();
+}
+
+void Game::think(std::chrono::steady_clock::time_point deadline)
+{
+    if (checkGameOver() != 0)
+        return;
+
+    // Each controller gets half of the time.  Take turns going first, so 
+    // that neither one always gets the fresher half.
+    using namespace std::chrono;
+    const steady_clock::time_point halfway = steady_clock::now() + (deadline - steady_clock::now()) / 2;
+    const bool bNorthFirst = (m_NumThinks++ % 2) == 0;
+
+    Player& first = bNorthFirst ? *m_pNorthPlayer : *m_pSouthPlayer;
+    Player& second = bNorthFirst ? *m_pSouthPlayer : *m_pNorthPlayer;
+    first.think(halfway);
+    second.think(deadline);
+}
+
+void Game::tickEntities(float deltaTSec)
+{
+    m_LiveBuildings.clear();
+    for (const Player* pPlayer : { m_pNorthPlayer, m_pSouthPlayer })
+    {
+        for (Entity* pBuilding : pPlayer->getBuildings()) {
+            if (!pBuilding->isDead()) {
+                m_LiveBuildings.push_back(pBuilding);
+            }
+        }
+    }
+    gatherLiveMobs();
+
+    // Mobs look for their neighbors in this while they move, so it has to be
+    // built before anyone ticks.
+    m_MobGrid.build(m_LiveMobs);
+    sortMobsByType();
+
+    Mob::TickAllFn tickFns[iEntityStats::numMobTypes];
+    for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+    {
+        tickFns[t] = Mob::getTickAll((iEntityStats::MobType)t);
+    }
+
+    // Entities only read each other's state and write their own, so they can
+    // tick in any order on any thread.  Anything they do to each other goes 
+    // into the intent buffer for the thread that they're ticking on.
+    //   The buildings come first, then the mobs a type at a time, so each job
+    // makes one call for each run of mobs of the same type that it gets.
+    const size_t numBuildings = m_LiveBuildings.size();
+    m_pJobs->parallelFor(numBuildings + m_MobsByType.size(), ksEntitiesPerJob,
+        [&](size_t begin, size_t end, unsigned int worker)
+        {
+            IntentBuffer& intents = m_Intents[worker];
+            for (; (begin < end) && (begin < numBuildings); ++begin)
+            {
+                m_LiveBuildings[begin]->tick(deltaTSec, intents);
+            }
+
+            if (begin == end)
+                return;
+
+            begin -= numBuildings;
+            end -= numBuildings;
+            for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+            {
+                const size_t first = std::max(begin, m_MobTypeStart[t]);
+                const size_t last = std::min(end, m_MobTypeStart[t + 1]);
+                if (first < last)
+                {
+                    tickFns[t](&m_MobsByType[first], last - first, deltaTSec, intents);
+                }
+            }
+        });
+}
+
+void Game::gatherLiveMobs()
+{
+    m_LiveMobs.clear();
+    for (const Player* pPlayer : { m_pNorthPlayer, m_pSouthPlayer })
+    {
+        for (Entity* m : pPlayer->getMobs()) {
+            if (!m->isDead()) {
+                m_LiveMobs.push_back(static_cast<Mob*>(m));
+            }
+        }
+    }
+}
+
+void Game::sortMobsByType()
+{
+    // A counting sort, so each type keeps the order from m_LiveMobs.
+    size_t counts[iEntityStats::numMobTypes] = {};
+    for (const Mob* pMob : m_LiveMobs)
+    {
+        ++counts[pMob->getMobType()];
+    }
+
+    m_MobTypeStart[0] = 0;
+    for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+    {
+        m_MobTypeStart[t + 1] = m_MobTypeStart[t] + counts[t];
+        counts[t] = m_MobTypeStart[t];
+    }
+
+    m_MobsByType.resize(m_LiveMobs.size());
+    for (Mob* pMob : m_LiveMobs)
+    {
+        m_MobsByType[counts[pMob->getMobType()]++] = pMob;
+    }
+}
+
+void Game::landProjectiles(float deltaTSec)
+{
+    // After the entities have ticked, so that they all saw the same health
+    // for everyone.  Anything that died before its projectile got there 
+    // just doesn't take the hit.
+    m_LandedDamage.clear();
+    m_Projectiles.advance(deltaTSec, m_LandedDamage);
+    for (const DamageIntent& hit : m_LandedDamage)
+    {
+        if (!hit.m_pTarget->isDead())
+        {
+            hit.m_pTarget->takeDamage(hit.m_Damage);
+        }
+    }
+}
+
+void Game::resolveIntents()
+{
+    // Gather the damage from every buffer and sort it by attacker, so that the
+    // results (and the log) don't depend on who ticked first or which thread
+    // ran what.  Each entity attacks at most once per tick, so ids are unique.
+    m_ResolvedDamage.clear();
+    m_ResolvedWakes.clear();
+    for (IntentBuffer& buffer : m_Intents)
+    {
+        const std::vector<DamageIntent>& damage = buffer.getDamage();
+        m_ResolvedDamage.insert(m_ResolvedDamage.end(), damage.begin(), damage.end());
+        const std::vector<Mob*>& wakes = buffer.getWakes();
+        m_ResolvedWakes.insert(m_ResolvedWakes.end(), wakes.begin(), wakes.end());
+        buffer.clear();
+    }
+
+    std::sort(m_ResolvedDamage.begin(), m_ResolvedDamage.end(),
+        [](const DamageIntent& a, const DamageIntent& b) 
+        { return a.m_pAttacker->getId() < b.m_pAttacker->getId(); });
+
+    // The same goes for the behaviors that are woken up, so that they're
+    // resumed in the same order.
+    std::sort(m_ResolvedWakes.begin(), m_ResolvedWakes.end(),
+        [](const Mob* a, const Mob* b) { return a->getId() < b->getId(); });
+    for (Mob* pMob : m_ResolvedWakes)
+    {
+        m_Behaviors.wake(pMob->getBehavior());
+    }
+
+    for (const DamageIntent& intent : m_ResolvedDamage)
+    {
+        if (m_bLogging)
+        {
+            char buff[200];
+            snprintf(buff, 200, "%s %s attacks %s %s for %d damage.\n",
+                     intent.m_pAttacker->isNorth() ? "North" : "South",
+                     intent.m_pAttacker->getStats().getName(),
+                     intent.m_pTarget->isNorth() ? "North" : "South",
+                     intent.m_pTarget->getStats().getName(),
+                     intent.m_Damage);
+            std::cout << buff;
+        }
+
+        // Ranged attacks take a while to get there (see landProjectiles()).
+        if (intent.m_pAttacker->getStats().getDamageType() == iEntityStats::Ranged)
+        {
+            const float dist = (float)intent.m_pAttacker->getPosition().dist(intent.m_pTarget->getPosition());
+            m_Projectiles.launch(intent.m_pAttacker, intent.m_pTarget, intent.m_Damage, dist / PROJECTILE_SPEED);
+        }
+        else
+        {
+            intent.m_pTarget->takeDamage(intent.m_Damage);
+        }
+        intent.m_pAttacker->scheduleNextAttack();
+    }
+
+    // Push apart any mobs that have ended up on top of each other.  Anything
+    // that just died no longer takes up space.
+    gatherLiveMobs();
+    m_Collisions.solve(m_LiveMobs);
+
+    // Then push them out of the river and the towers.  That goes last, 
+    // because it's the one that's not allowed to be violated.
+    updateArena();
+    for (Mob* pMob : m_LiveMobs)
+    {
+        Vec2 pos = pMob->getNextPosition();
+        if (m_Arena.pushOut(pos, Real(pMob->getStats().getSize()) / Real(2)))
+        {
+            pMob->setNextPosition(pos);
+        }
+    }
+
+    m_pNorthPlayer->commitEntities();
+    m_pSouthPlayer->commitEntities();
+
+    // Before removeDeadMobs(), so that the dead get taken out of the hash
+    // and the influence maps.
+    updateStateHash();
+    m_pNorthPlayer->updateInfluence();
+    m_pSouthPlayer->updateInfluence();
+}
+
+void Game::updateArena()
+{
+    // Towers never come back, so the count tells us whether anything has
+    // changed without gathering the circles every tick.
+    size_t numStanding = 0;
+    for (const Player* pPlayer : { m_pNorthPlayer, m_pSouthPlayer })
+    {
+        for (const Entity* pBuilding : pPlayer->getBuildings()) {
+            if (!pBuilding->isDead()) {
+                ++numStanding;
+            }
+        }
+    }
+
+    if (numStanding == m_NumStandingTowers)
+        return;
+
+    m_TowerCircles.clear();
+    for (const Player* pPlayer : { m_pNorthPlayer, m_pSouthPlayer })
+    {
+        for (const Entity* pBuilding : pPlayer->getBuildings()) {
+            if (!pBuilding->isDead()) {
+                m_TowerCircles.push_back({ pBuilding->getPosition(), Real(pBuilding->getStats().getSize()) / Real(2) });
+            }
+        }
+    }
+
+    m_NumStandingTowers = numStanding;
+    m_Arena.build(m_TowerCircles);
+}
+
+// Sets the hidden bit for each of the mobs (all of type T) that has cover.
+// Attacking gives a mob away, though - once it's locked on to a target it's
+// visible until that target dies.
+template <iEntityStats::MobType T>
+static void markHidden(const Game& game, Mob* const* ppMobs, size_t numMobs, std::vector<uint64_t>& hiddenBits)
+{
+    if (!MobBehavior<T>::kbCanHide)
+        return;
+
+    for (size_t i = 0; i < numMobs; ++i)
+    {
+        const Mob& mob = *ppMobs[i];
+        if (!mob.hasTargetLock() && MobBehavior<T>::hasCover(mob, game))
+        {
+            const unsigned int id = mob.getId();
+            hiddenBits[id / 64] |= (uint64_t)1 << (id % 64);
+        }
+    }
+}
+
+typedef void (*MarkHiddenFn)(const Game& game, Mob* const* ppMobs, size_t numMobs, std::vector<uint64_t>& hiddenBits);
+
+template <iEntityStats::MobType... Types>
+static const MarkHiddenFn* buildMarkHiddenTable(MobTypeList<Types...>)
+{
+    static const MarkHiddenFn ksTable[] = { &markHidden<Types>... };
+    return ksTable;
+}
+
+void Game::updateVisibility()
+{
+    m_HiddenBits.assign((m_NextEntityId + 63) / 64, 0);
+
+    // Everyone's still alive at this point, so there's nothing to filter.
+    gatherLiveMobs();
+    sortMobsByType();
+
+    static const MarkHiddenFn* const kpMarkHidden = buildMarkHiddenTable(AllMobTypes());
+    for (int t = 0; t < iEntityStats::numMobTypes; ++t)
+    {
+        kpMarkHidden[t](*this, m_MobsByType.data() + m_MobTypeStart[t], 
+                        m_MobTypeStart[t + 1] - m_MobTypeStart[t], m_HiddenBits);
+    }
+}
+
+void Game::updateStateHash()
+{
+    // Only the entities that changed do any hashing, so this is just a walk
+    // over the flags for most of them.
+    for (const Player* pPlayer : { m_pNorthPlayer, m_pSouthPlayer })
+    {
+        for (Entity* pBuilding : pPlayer->getBuildings()) {
+            m_StateHash ^= pBuilding->refreshStateHash();
+        }
+        for (Entity* pMob : pPlayer->getMobs()) {
+            m_StateHash ^= pMob->refreshStateHash();
+        }
+    }
+}
+
+void Game::setControllerBudget(const ControllerBudget::Settings& settings)
+{
+    m_pNorthPlayer->getBudget().setSettings(settings);
+    m_pSouthPlayer->getBudget().setSettings(settings);
+}
+
+void Game::setStressMode(bool bStressMode)
+{
+    m_pNorthPlayer->setStressMode(bStressMode);
+    m_pSouthPlayer->setStressMode(bStressMode);
+}
+
+void Game::printControllerStats(std::ostream& out) const
+{
+    m_pNorthPlayer->getBudget().print(out, "North controller");
+    m_pSouthPlayer->getBudget().print(out, "South controller");
 }
 
 int Game::checkGameOver() {
     if (gameOverState == 0) {
+        // A controller that ran out of time loses.  North ticks first, so
+        // if it ran out then it did so first.
+        if (m_pNorthPlayer->getBudget().hasForfeited())
+        {
+            gameOverState = -1;
+            return gameOverState;
+        }
+        if (m_pSouthPlayer->getBudget().hasForfeited())
+        {
+            gameOverState = 1;
+            return gameOverState;
+        }
+
         // The king towers should always have index 0.
         iPlayer::EntityData northKingData = m_pNorthPlayer->getBuilding(0);
         assert(northKingData.m_Stats.getBuildingType() == iEntityStats::King);
@@ -81,27 +471,33 @@ int Game::checkGameOver() {
 
 void Game::buildPlayers(iController* pNorthControl, iController* pSouthControl)
 {
-    m_pNorthPlayer = new Player(pNorthControl, true);
-    m_pSouthPlayer = new Player(pSouthControl, false);
+    m_pNorthPlayer = new Player(*this, pNorthControl, true);
+    m_pSouthPlayer = new Player(*this, pSouthControl, false);
 }
 
 void Game::buildWaypoints()
 {
     // The first waypoint is 1 tile toward the center of the princess tower
     const float princessSize = iEntityStats::getBuildingStats(iEntityStats::Princess).getSize();
-    const Vec2 first(PrincessLeftX + (princessSize / 2.f) + 1.f, NorthPrincessY);
+    const Vec2 princessPos = m_Layout.getPrincessPos(true, true);
+    const Vec2 first(princessPos.x + Real(princessSize / 2.f + 1.f), princessPos.y);
     addFourWaypoints(first);
 
-    for (float y = first.y + WAYPOINT_Y_INCREMENT; y < RIVER_TOP_Y; y += WAYPOINT_Y_INCREMENT)
+    // The lanes are straight, so on a long one we don't need as many.  Mobs
+    // look through all of them (see Mob::pickWaypoint()), so keep it short.
+    static const float ksMaxWaypointsPerLane = 8.f;
+    const Real laneLength = Real(m_Layout.getRiverTopY()) - first.y;
+    const Real increment = std::max(Real(WAYPOINT_Y_INCREMENT), laneLength / Real(ksMaxWaypointsPerLane));
+    for (Real y = first.y + increment; y < Real(m_Layout.getRiverTopY()); y += increment)
     {
-        addFourWaypoints(Vec2(LEFT_BRIDGE_CENTER_X, y));
+        addFourWaypoints(Vec2(Real(m_Layout.getBridgeCenterX(true)), y));
     }
 }
 
 void Game::addFourWaypoints(Vec2 pt)
 {
-    const float rightX = GAME_GRID_WIDTH - pt.x;
-    const float bottomY = GAME_GRID_HEIGHT - pt.y;
+    const Real rightX = Real(m_Layout.getWidth()) - pt.x;
+    const Real bottomY = Real(m_Layout.getHeight()) - pt.y;
 
     m_Waypoints.push_back(pt);
     m_Waypoints.push_back(Vec2(rightX, pt.y));
@@ -22,42 +22,192 @@
 
 #pragma once
 
-#include "Singleton.h"
+#include "ArenaField.h"
+#include "ArenaLayout.h"
+#include "BehaviorScheduler.h"
+#include "CollisionSolver.h"
+#include "ControllerBudget.h"
+#include "IntentBuffer.h"
+#include "MobGrid.h"
+#include "ProjectilePool.h"
+#include "TimingWheel.h"
 #include "Vec2.h"
+#include <chrono>
+#include <ostream>
+#include <stdint.h>
 #include <vector>
 
 class Building;
+class Entity;
 class iController;
+class JobSystem;
 class Mob;
 class Player;
 
-class Game : public Singleton<Game>
+// A single match.  You can have as many of these as you like (e.g. a server
+// hosting lots of matches at once), so entities hold on to the Game they
+// belong to rather than looking it up.
+class Game
 {
 public:
-    explicit Game();
+    // NOTE: we take ownership of the controllers.  If a controller is NULL then
+    // that player will just passively sit there and let you kill it.
+    //   numThreads is passed to setNumThreads().
+    //   layout is the size and shape of the arena (the standard one by default).
+    Game(iController* pNorthControl, iController* pSouthControl, unsigned int numThreads = 0,
+         const ArenaLayout& layout = ArenaLayout());
     virtual ~Game();
 
     void tick(float deltaTSec);
 
+    // Give the time until deadline to the controllers (see 
+    // iController::think()), split evenly between them.  Call this instead
+    // of spinning while you wait for the next tick.
+    void think(std::chrono::steady_clock::time_point deadline);
+
     Player& getPlayer(bool bNorth) { return bNorth ? *m_pNorthPlayer : *m_pSouthPlayer; }
+    const Player& getPlayer(bool bNorth) const { return bNorth ? *m_pNorthPlayer : *m_pSouthPlayer; }
+
+    const ArenaLayout& getLayout() const { return m_Layout; }
 
     const std::vector<Vec2>& getWaypoints() const { return m_Waypoints; }
 
+    // Distance to the river, the towers that are still standing, and the 
+    // edges of the arena.
+    const ArenaField& getArena() const { return m_Arena; }
+
+    // A hash of the id, position, health and target of every live entity, 
+    // as of the end of the last tick.  Runs of the same match (on different
+    // builds, or with different numbers of threads) should have the same 
+    // hash after every tick - the first tick where they don't is where they
+    // diverged.  See Entity::getStateHash().
+    uint64_t getStateHash() const { return m_StateHash; }
+
+    // The ranged attacks that haven't landed yet.
+    const ProjectilePool& getProjectiles() const { return m_Projectiles; }
+
+    // Whether the entity with the given id is hidden (see updateVisibility()),
+    // as of the end of the last tick.
+    bool isHidden(unsigned int id) const 
+        { return (id / 64 < m_HiddenBits.size()) && ((m_HiddenBits[id / 64] >> (id % 64)) & 1); }
+
+    // Where the mobs were at the start of this tick (see MobGrid).
+    const MobGrid& getMobGrid() const { return m_MobGrid; }
+
+    // The game time (in seconds) since the start of the match.
+    float getTime() const { return m_Time; }
+
+    // Use this to schedule anything that should happen at a specific game 
+    // time (attack cooldowns, spawn delays, spells...), rather than polling
+    // for it every tick.
+    TimingWheel& getTimers() { return m_Timers; }
+
+    // Runs the mobs' multi-tick behaviors (see Behavior).
+    BehaviorScheduler& getBehaviors() { return m_Behaviors; }
+
+    unsigned int allocateEntityId() { return m_NextEntityId++; }
+
+    // How many threads to use when ticking entities (including this one).
+    // 0 => one per hardware thread.  The results are the same regardless.
+    void setNumThreads(unsigned int numThreads);
+    unsigned int getNumThreads() const;
+
+    // Limit how much time each controller may spend in tick() (see 
+    // ControllerBudget).  A controller that uses up its match budget forfeits.
+    void setControllerBudget(const ControllerBudget::Settings& settings);
+
+    // Print how long each controller has been taking.
+    void printControllerStats(std::ostream& out) const;
+
+    // Let both players place as many mobs as they like, wherever they like
+    // (see Player::setStressMode()).
+    void setStressMode(bool bStressMode);
+
     int checkGameOver();
 
+    // Whether to print the play-by-play (attacks, failed placements) to 
+    // stdout.  On by default.
+    void setLogging(bool bLogging) { m_bLogging = bLogging; }
+    bool isLogging() const { return m_bLogging; }
+
 private:
     void buildPlayers(iController* pNorthControl, iController* pSouthControl);
 
     void buildWaypoints();
     void addFourWaypoints(Vec2 pt);
 
+    void tickEntities(float deltaTSec);
+
+    // Fills m_LiveMobs with the mobs that aren't dead, and then 
+    // m_MobsByType with the same mobs, grouped by type.
+    void gatherLiveMobs();
+    void sortMobsByType();
+    void landProjectiles(float deltaTSec);
+    void resolveIntents();
+
+    // Rebakes m_Arena if any towers have fallen since the last time.
+    void updateArena();
+
+    // Folds in the hashes of any entities that changed (or spawned, or died)
+    // since the last time.
+    void updateStateHash();
+
+    // Works out which entities are hidden, once per tick, so that anything 
+    // that asks (targeting, drawing...) just reads a bit.
+    void updateVisibility();
+
 private:
+    // This comes first, since everything else is built from it.
+    const ArenaLayout m_Layout;
+
     Player* m_pNorthPlayer;
     Player* m_pSouthPlayer;
 
     std::vector<Vec2> m_Waypoints;
 
+    float m_Time;
+    TimingWheel m_Timers;
+    BehaviorScheduler m_Behaviors;      // after m_Timers, which it uses
+    unsigned int m_NumThinks;
+    unsigned int m_NextEntityId;
+
+    JobSystem* m_pJobs;                 // owned
+    std::vector<Entity*> m_LiveBuildings;
+    MobGrid m_MobGrid;
+
+    // One buffer for each thread that ticks entities.  They're merged (in a
+    // deterministic order) by resolveIntents().
+    std::vector<IntentBuffer> m_Intents;
+    std::vector<DamageIntent> m_ResolvedDamage;
+    std::vector<Mob*> m_ResolvedWakes;
+
+    ProjectilePool m_Projectiles;
+    std::vector<DamageIntent> m_LandedDamage;
+
+    CollisionSolver m_Collisions;
+    std::vector<Mob*> m_LiveMobs;
+
+    // m_LiveMobs grouped by type.  The mobs of type t are the ones from 
+    // m_MobTypeStart[t] up to (but not including) m_MobTypeStart[t + 1].
+    std::vector<Mob*> m_MobsByType;
+    size_t m_MobTypeStart[iEntityStats::numMobTypes + 1];
+
+    ArenaField m_Arena;
+    size_t m_NumStandingTowers;
+    std::vector<ArenaField::Circle> m_TowerCircles;     // only used by updateArena()
+
+    uint64_t m_StateHash;               // XOR of every entity's hash
+
+    std::vector<uint64_t> m_HiddenBits; // indexed by entity id
+
+    bool m_bLogging;
+
     // Negative => South won, Positive => North won, 0 => no winner yet
     int gameOverState; 
+
+private:
+    // DELIBERATELY UNDEFINED
+    Game(const Game& rhs);
+    Game& operator=(const Game& rhs);
 };
 
@@ -84,8 +84,8 @@ void Graphics::drawMob(Entity* m)
         }
     }
 
-	float centerX = m->getPosition().x * PIXELS_PER_METER;
-	float centerY = m->getPosition().y * PIXELS_PER_METER;
+	float centerX = (float)m->getPosition().x * PIXELS_PER_METER;
+	float centerY = (float)m->getPosition().y * PIXELS_PER_METER;
 	float squareSize = m->getStats().getSize() * PIXELS_PER_METER;
 
 	drawSquare(centerX, centerY, squareSize);
@@ -129,11 +129,20 @@ void Graphics::drawBuilding(Entity* b) {
     else
         SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0xFF, alpha);
 
-    drawSquare(b->getPosition().x * PIXELS_PER_METER,
-        b->getPosition().y * PIXELS_PER_METER,
+    drawSquare((float)b->getPosition().x * PIXELS_PER_METER,
+        (float)b->getPosition().y * PIXELS_PER_METER,
         b->getStats().getSize() * PIXELS_PER_METER);
 }
 
+void Graphics::drawProjectiles(const ProjectilePool& projectiles) {
+    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    for (size_t i = 0; i < projectiles.getNumProjectiles(); ++i)
+    {
+        const Vec2 pos = projectiles.getPosition(i);
+        drawSquare((float)pos.x * PIXELS_PER_METER, (float)pos.y * PIXELS_PER_METER, 0.2f * PIXELS_PER_METER);
+    }
+}
+
 void Graphics::drawText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color) {
     // Draws the given text in a box with the specified position and dimention
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "ProjectilePool.h"
 #include "SDL.h"
 #include "SDL_image.h"
 #include "SDL_ttf.h"
@@ -19,6 +20,7 @@ public:
 	void drawMob(Entity* m);
 	void drawText(const char* textToDraw, SDL_Rect messageRect, SDL_Color color);
 	void drawBuilding(Entity* b);
+	void drawProjectiles(const ProjectilePool& projectiles);
 
 	void resetFrame();
 
@@ -0,0 +1,66 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+class Entity;
+class Mob;
+
+// Everything an entity wants to do to *other* entities during a tick.  
+// Entities never modify each other directly while ticking - they push their
+// intents into one of these, and Game::resolveIntents() applies them once
+// every entity has ticked.  That way every entity sees the same (previous
+// tick's) state, no matter which side or which thread ticks first.
+// NOTE: Changes to an entity's own state (like where it's moving to) live on
+// the entity itself, see Entity::commit().
+struct DamageIntent
+{
+    Entity* m_pAttacker;
+    Entity* m_pTarget;
+    int m_Damage;
+};
+
+class IntentBuffer
+{
+public:
+    IntentBuffer() {}
+
+    void pushDamage(Entity* pAttacker, Entity* pTarget, int damage)
+    {
+        DamageIntent intent = { pAttacker, pTarget, damage };
+        m_Damage.push_back(intent);
+    }
+
+    // pMob's behavior has something to wake up for (see Behavior::WakeEvent).
+    void pushWake(Mob* pMob) { m_Wakes.push_back(pMob); }
+
+    const std::vector<DamageIntent>& getDamage() const { return m_Damage; }
+    const std::vector<Mob*>& getWakes() const { return m_Wakes; }
+
+    void clear() { m_Damage.clear(); m_Wakes.clear(); }
+
+private:
+    std::vector<DamageIntent> m_Damage;
+    std::vector<Mob*> m_Wakes;
+};
@@ -0,0 +1,163 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <assert.h>
+
+JobSystem::JobSystem(unsigned int numThreads)
+    : m_Generation(0)
+    , m_bQuit(false)
+    , m_pFn(NULL)
+    , m_JobsRemaining(0)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        m_Workers.push_back(new Worker);
+    }
+
+    for (unsigned int i = 1; i < numThreads; ++i)
+    {
+        m_Threads.push_back(std::thread(&JobSystem::workerMain, this, i));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeLock);
+        m_bQuit = true;
+    }
+    m_WakeCond.notify_all();
+
+    for (std::thread& t : m_Threads) t.join();
+    for (Worker* pWorker : m_Workers) delete pWorker;
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize, const RangeFn& fn)
+{
+    if (count == 0)
+        return;
+
+    chunkSize = std::max((size_t)1, chunkSize);
+
+    // Not worth waking anyone up for a single chunk.
+    if ((count <= chunkSize) || m_Threads.empty())
+    {
+        fn(0, count, 0);
+        return;
+    }
+
+    assert(m_JobsRemaining == 0);
+    const size_t numJobs = (count + chunkSize - 1) / chunkSize;
+    m_pFn = &fn;
+    m_JobsRemaining = numJobs;
+
+    // Deal the chunks out round robin, so that everyone starts with some
+    // work close to their share, and rely on stealing to even it out.
+    for (size_t i = 0; i < numJobs; ++i)
+    {
+        Job job = { i * chunkSize, std::min(count, (i + 1) * chunkSize) };
+        Worker& worker = *m_Workers[i % m_Workers.size()];
+        std::lock_guard<std::mutex> lock(worker.m_Lock);
+        worker.m_Jobs.push_back(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeLock);
+        ++m_Generation;
+    }
+    m_WakeCond.notify_all();
+
+    runJobs(0);
+
+    // Someone else may still be finishing their last job.
+    while (m_JobsRemaining.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    m_pFn = NULL;
+}
+
+void JobSystem::workerMain(unsigned int worker)
+{
+    unsigned long long seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_WakeLock);
+            m_WakeCond.wait(lock, [&]() { return m_bQuit || (m_Generation != seenGeneration); });
+            if (m_bQuit)
+                return;
+            seenGeneration = m_Generation;
+        }
+
+        runJobs(worker);
+    }
+}
+
+void JobSystem::runJobs(unsigned int worker)
+{
+    Job job;
+    while (popJob(worker, job))
+    {
+        (*m_pFn)(job.m_Begin, job.m_End, worker);
+        m_JobsRemaining.fetch_sub(1);
+    }
+}
+
+bool JobSystem::popJob(unsigned int worker, Job& job)
+{
+    // Our own work first, newest first (it's the most likely to be in cache)...
+    {
+        Worker& self = *m_Workers[worker];
+        std::lock_guard<std::mutex> lock(self.m_Lock);
+        if (!self.m_Jobs.empty())
+        {
+            job = self.m_Jobs.back();
+            self.m_Jobs.pop_back();
+            return true;
+        }
+    }
+
+    // ... then steal the oldest job from someone else.
+    const size_t numWorkers = m_Workers.size();
+    for (size_t i = 1; i < numWorkers; ++i)
+    {
+        Worker& victim = *m_Workers[(worker + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.m_Lock);
+        if (!victim.m_Jobs.empty())
+        {
+            job = victim.m_Jobs.front();
+            victim.m_Jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,90 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+// A small fork/join job system.  Each worker has its own deque of jobs; it
+// pops work from the back of its own deque and, when that runs dry, steals
+// from the front of everyone else's.  The calling thread acts as worker 0,
+// so a JobSystem with one thread runs everything inline.
+class JobSystem
+{
+public:
+    // fn is called with the half-open range [begin, end) and the index of the
+    // worker running it (in [0, getNumThreads())), which is handy for 
+    // indexing per-thread scratch buffers.
+    typedef std::function<void(size_t begin, size_t end, unsigned int worker)> RangeFn;
+
+    // numThreads includes the calling thread.  0 => one per hardware thread.
+    explicit JobSystem(unsigned int numThreads);
+    ~JobSystem();
+
+    unsigned int getNumThreads() const { return (unsigned int)m_Workers.size(); }
+
+    // Split [0, count) into chunks of chunkSize and run fn over all of them,
+    // returning once every chunk is done.  Only call this from the thread 
+    // that created the JobSystem.
+    void parallelFor(size_t count, size_t chunkSize, const RangeFn& fn);
+
+private:
+    struct Job
+    {
+        size_t m_Begin;
+        size_t m_End;
+    };
+
+    struct Worker
+    {
+        std::mutex m_Lock;
+        std::deque<Job> m_Jobs;
+    };
+
+    void workerMain(unsigned int worker);
+    void runJobs(unsigned int worker);
+    bool popJob(unsigned int worker, Job& job);
+
+private:
+    std::vector<Worker*> m_Workers;         // owned
+    std::vector<std::thread> m_Threads;     // m_Threads[i] runs worker i + 1
+
+    std::mutex m_WakeLock;
+    std::condition_variable m_WakeCond;
+    unsigned long long m_Generation;        // bumped every parallelFor()
+    bool m_bQuit;
+
+    const RangeFn* m_pFn;                   // NOT owned, valid during parallelFor()
+    std::atomic<size_t> m_JobsRemaining;
+
+private:
+    // DELIBERATELY UNDEFINED
+    JobSystem(const JobSystem& rhs);
+    JobSystem& operator=(const JobSystem& rhs);
+};
@@ -22,78 +22,163 @@
 
 #include "Mob.h"
 
+#include "BehaviorScheduler.h"
 #include "Constants.h"
 #include "Game.h"
+#include "MobBehavior.h"
+#include "MobGrid.h"
+#include "OrcaSteering.h"
 
 #include <algorithm>
 #include <vector>
 
 
-Mob::Mob(const iEntityStats& stats, const Vec2& pos, bool isNorth)
-    : Entity(stats, pos, isNorth)
+typedef Behavior* (*StartBehaviorFn)(Mob& mob, BehaviorScheduler& scheduler);
+
+template <iEntityStats::MobType... Types>
+static const StartBehaviorFn* buildStartBehaviorTable(MobTypeList<Types...>)
+{
+    static const StartBehaviorFn ksTable[] = { &MobBehavior<Types>::startBehavior... };
+    return ksTable;
+}
+
+static StartBehaviorFn getStartBehavior(iEntityStats::MobType type)
+{
+    static const StartBehaviorFn* const kpTable = buildStartBehaviorTable(AllMobTypes());
+    assert((size_t)type < iEntityStats::numMobTypes);
+    return kpTable[type];
+}
+
+Mob::Mob(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth)
+    : Entity(game, stats, pos, isNorth)
+    , m_Type(stats.getMobType())
     , m_pWaypoint(NULL)
+    , m_NextPos(pos)
+    , m_Velocity(0.f, 0.f)
+    , m_NextVelocity(0.f, 0.f)
+    , m_pBehavior(NULL)
+    , m_WakeOn(0)
+    , m_WakeRange(0.f)
+    , m_Speed(stats.getSpeed())
+    , m_bHoldBack(false)
 {
     assert(dynamic_cast<const iEntityStats_Mob*>(&stats) != NULL);
+    m_pBehavior = getStartBehavior(m_Type)(*this, game.getBehaviors());
 }
 
-void Mob::tick(float deltaTSec)
+void Mob::commit()
 {
-    // Tick the entity first.  This will pick our target, and attack it if it's in range.
-    Entity::tick(deltaTSec);
-
-    // if our target isn't in range, move towards it.
-    if (!targetInRange())
+    if (m_NextPos != m_Pos)
     {
-        move(deltaTSec);
+        m_Pos = m_NextPos;
+        markHashDirty();
     }
+    m_Velocity = m_NextVelocity;
 }
 
-bool Mob::isHidden() const
+void Mob::tick(float deltaTSec, IntentBuffer& intents)
 {
-    // Project 2: This is where you should put the logic for checking if a Rogue is
-    // hidden or not.  It probably involves something related to calling Game::Get()
-    // to get the Game, then calling getPlayer() on the game to get each player, then
-    // going through all the entities on the players and... well, you can take it 
-    // from there.  Once you've implemented this function, you can use it elsewhere to
-    // change the Rogue's behavior, damage, etc.  It is also used in by the Graphics
-    // to change the way the character renders (Rogues on the South team will render
-    // as grayed our when hidden, ones on the North team won't render at all).
-
-    // TODO: This special case code for the Rogue doesn't belong in the Mob class - we
-    // need some way to encapsulate and decouple.  I'm thinking maybe a lambda in the
-    // EntityStats??
-
-    // As a placeholder, just mark Rogues as always hidden.
-    return getStats().getMobType() == iEntityStats::MobType::Rogue;
+    Mob* const pThis = this;
+    getTickAll(m_Type)(&pThis, 1, deltaTSec, intents);
 }
 
-void Mob::move(float deltaTSec)
+template <iEntityStats::MobType T>
+void Mob::tickAll(Mob* const* ppMobs, size_t numMobs, float deltaTSec, IntentBuffer& intents)
 {
-    // Project 2: You'll likely need to do some work in this function to get the 
-    // Rogue to move correctly (i.e. hide behind Giant or Tower, move with the Giant,
-    // spring out when doing a sneak attack, etc).
-    //   Of note, putting special case code for a single type of unit into the base
-    // class function like this IS AN AWFUL IDEA, because it wouldn't scale as more
-    // types of units are added.  We only have the one special unit type, so we can 
-    // afford to be a lazy in this instance... but if this were production code, I 
-    // would never do it this way!!
-    //   TODO: Build a better system for encapsulating unit-specific logic, perhaps
-    // by repurposing and expanding the EntityStats subclasses (which need some love
-    // as well!)
+    for (size_t i = 0; i < numMobs; ++i)
+    {
+        Mob& mob = *ppMobs[i];
+        assert(mob.m_Type == T);
 
-    // If we have a target and it's on the same side of the river, we move towards it.
-    //  Otherwise, we move toward the bridge.
-    bool bMoveToTarget = false;
-    if (!!m_pTarget)
-    {    
-        bool imTop = m_Pos.y < (GAME_GRID_HEIGHT / 2);
-        bool otherTop = m_pTarget->getPosition().y < (GAME_GRID_HEIGHT / 2);
-
-        if (imTop == otherTop)
+        mob.m_NextPos = mob.m_Pos;
+        mob.m_NextVelocity = Vec2(0.f, 0.f);
+
+        // Tick the entity first.  This will pick our target, and attack it if it's in range.
+        const bool bWasAttackReady = mob.m_bAttackReady;
+        mob.Entity::tick(deltaTSec, intents);
+
+        // if our target isn't in range, move towards it (or wherever our
+        // type would rather be, if it isn't on our side of the river or 
+        // we're holding back).
+        if (!mob.targetInRange())
+        {
+            Vec2 idleDest;
+            const bool bIdle = (mob.m_bHoldBack || !mob.isTargetOnOurSide())
+                && MobBehavior<T>::pickIdleDestination(mob, mob.m_Game, idleDest);
+            mob.move(deltaTSec, bIdle ? &idleDest : NULL);
+        }
+
+        // Only once per wait - the behavior sets a new one when it resumes.
+        if (MobBehavior<T>::kbHasBehavior && (mob.m_WakeOn != 0) 
+            && mob.checkWake(bWasAttackReady && !mob.m_bAttackReady))
         {
-            bMoveToTarget = true;
+            mob.m_WakeOn = 0;
+            intents.pushWake(&mob);
         }
     }
+}
+
+template <iEntityStats::MobType... Types>
+static const Mob::TickAllFn* buildTickAllTable(MobTypeList<Types...>)
+{
+    static const Mob::TickAllFn ksTable[] = { &Mob::tickAll<Types>... };
+    return ksTable;
+}
+
+Mob::TickAllFn Mob::getTickAll(iEntityStats::MobType type)
+{
+    static const TickAllFn* const kpTable = buildTickAllTable(AllMobTypes());
+    assert((size_t)type < iEntityStats::numMobTypes);
+    return kpTable[type];
+}
+
+void Mob::stopBehavior()
+{
+    m_Game.getBehaviors().stop(m_pBehavior);
+    m_pBehavior = NULL;
+    m_WakeOn = 0;
+}
+
+bool Mob::checkWake(bool bAttacked) const
+{
+    if ((m_WakeOn & Behavior::WakeOnAttack) && bAttacked)
+        return true;
+
+    if ((m_WakeOn & Behavior::WakeOnTargetLost) && !m_bTargetLock)
+        return true;
+
+    if ((m_WakeOn & Behavior::WakeOnTargetInRange) && !!m_pTarget)
+    {
+        const Real range = Real(m_WakeRange + (m_Stats.getSize() + m_pTarget->getStats().getSize()) / 2.f);
+        return m_Pos.distSqr(m_pTarget->getPosition()) <= range * range;
+    }
+
+    return false;
+}
+
+bool Mob::isHidden() const
+{
+    // Worked out for everyone at once, at the end of each tick (see 
+    // Game::updateVisibility()).
+    return m_Game.isHidden(m_Id);
+}
+
+bool Mob::isTargetOnOurSide() const
+{
+    if (!m_pTarget)
+        return false;
+
+    const Real halfHeight = Real(m_Game.getLayout().getHeight() / 2);
+    bool imTop = m_Pos.y < halfHeight;
+    bool otherTop = m_pTarget->getPosition().y < halfHeight;
+    return imTop == otherTop;
+}
+
+void Mob::move(float deltaTSec, const Vec2* pIdleDest)
+{
+    // If we have a target and it's on the same side of the river, we move towards it.
+    //  Otherwise, we move toward our idle destination, if we have one, or the bridge.
+    const bool bMoveToTarget = !pIdleDest && isTargetOnOurSide();
 
     Vec2 destPos;
     if (bMoveToTarget)
@@ -101,77 +186,105 @@ void Mob::move(float deltaTSec)
         m_pWaypoint = NULL;
         destPos = m_pTarget->getPosition();
     }
+    else if (pIdleDest)
+    {
+        m_pWaypoint = NULL;
+        destPos = *pIdleDest;
+    }
     else
     {
-        if (!m_pWaypoint)
+        // Waypoints are just there to get us to the bridge, so we don't need
+        // to hit them exactly (and in a crowd, we couldn't).
+        static const float ksWaypointArrivalRadius = 1.f;
+        if (!m_pWaypoint || (m_Pos.distSqr(*m_pWaypoint) < Real(ksWaypointArrivalRadius * ksWaypointArrivalRadius)))
         {
-            m_pWaypoint = pickWaypoint();
+            m_pWaypoint = pickWaypoint(m_Pos);
         }
         destPos = m_pWaypoint ? *m_pWaypoint : m_Pos;
     }
 
     // Actually do the moving
-    Vec2 moveVec = destPos - m_Pos;
-    float distRemaining = moveVec.normalize();
-    float moveDist = m_Stats.getSpeed() * deltaTSec;
+    Vec2 moveVec = destPos - m_NextPos;
+    Real distRemaining = moveVec.normalize();
+    Real moveDist = Real(m_Speed) * Real(deltaTSec);
 
     // if we're moving to m_pTarget, don't move into it
     if (bMoveToTarget)
     {
         assert(m_pTarget);
         distRemaining -= (m_Stats.getSize() + m_pTarget->getStats().getSize()) / 2.f;
-        distRemaining = std::max(0.f, distRemaining);
+        distRemaining = std::max(Real(0), distRemaining);
     }
 
     if (moveDist <= distRemaining)
     {
-        m_Pos += moveVec * moveDist;
+        m_NextPos += moveVec * moveDist;
     }
     else
     {
-        m_Pos += moveVec * distRemaining;
+        m_NextPos += moveVec * distRemaining;
 
         // if the destination was a waypoint, find the next one and continue movement
         if (m_pWaypoint)
         {
-            m_pWaypoint = pickWaypoint();
-            destPos = m_pWaypoint ? *m_pWaypoint : m_Pos;
-            moveVec = destPos - m_Pos;
+            m_pWaypoint = pickWaypoint(m_NextPos);
+            destPos = m_pWaypoint ? *m_pWaypoint : m_NextPos;
+            moveVec = destPos - m_NextPos;
             moveVec.normalize();
-            m_Pos += moveVec * distRemaining;
+            m_NextPos += moveVec * distRemaining;
         }
     }
 
-    // Project 1: This is where your collision code will be called from
-    Mob* otherMob = checkCollision();
-    if (otherMob) {
-        processCollision(otherMob, deltaTSec);
-    }
+    // That's where we'd like to go.  Steer so that we won't walk into anyone
+    // on the way (which keeps crowds moving through the bridges, rather than
+    // piling up), and leave whatever overlap is left to the CollisionSolver.
+    const Vec2 preferredVelocity = (m_NextPos - m_Pos) / Real(deltaTSec);
+    m_NextVelocity = avoidNeighbors(preferredVelocity, deltaTSec);
+    m_NextPos = m_Pos + m_NextVelocity * Real(deltaTSec);
 }
 
-const Vec2* Mob::pickWaypoint()
+Vec2 Mob::avoidNeighbors(const Vec2& preferredVelocity, float deltaTSec) const
 {
-    // Project 2:  You may need to make some adjustments here, so that Rogues will go
-    // back to a friendly tower when they have nothing to attack or hide behind, rather 
-    // than suicide-rushing the enemy tower (which they can't damage).
-    //   Again, special-case code in a base class function bad.  Encapsulation good.
+    // Only the closest few neighbors within this distance count (see 
+    // OrcaSteering::ksMaxNeighbors), so crowds cost the same as a handful.
+    static const float ksNeighborRadius = 3.f;
+
+    const Real radius = Real(m_Stats.getSize() / 2.f);
+    const Mob* neighbors[OrcaSteering::ksMaxNeighbors];
+    const size_t numNeighbors = m_Game.getMobGrid().findNearest(m_Pos, Real(ksNeighborRadius) + radius,
+                                                                this, neighbors, OrcaSteering::ksMaxNeighbors);
+    if (numNeighbors == 0)
+        return preferredVelocity;
+
+    OrcaSteering steering(m_Pos, m_Velocity, radius);
+    for (size_t i = 0; i < numNeighbors; ++i)
+    {
+        const Mob& other = *neighbors[i];
+        const Vec2& otherVel = other.getVelocity();
+        steering.addNeighbor(other.getPosition(), otherVel, Real(other.getStats().getSize() / 2.f),
+                             otherVel.lengthSqr() > Real(0));
+    }
 
+    return steering.solve(preferredVelocity, Real(m_Speed), deltaTSec);
+}
 
-    float smallestDistSq = FLT_MAX;
+const Vec2* Mob::pickWaypoint(const Vec2& pos)
+{
+    Real smallestDistSq = REAL_MAX;
     const Vec2* pClosest = NULL;
 
-    for (const Vec2& pt : Game::get().getWaypoints())
+    for (const Vec2& pt : m_Game.getWaypoints())
     {
         // Filter out any waypoints that are behind (or barely in front of) us.
         // NOTE: (0, 0) is the top left corner of the screen
-        float yOffset = pt.y - m_Pos.y;
+        Real yOffset = pt.y - pos.y;
         if ((m_bNorth && (yOffset < 1.f)) ||
             (!m_bNorth && (yOffset > -1.f)))
         {
             continue;
         }
 
-        float distSq = m_Pos.distSqr(pt);
+        Real distSq = pos.distSqr(pt);
         if (distSq < smallestDistSq) {
             smallestDistSq = distSq;
             pClosest = &pt;
@@ -180,26 +293,3 @@ const Vec2* Mob::pickWaypoint()
 
     return pClosest;
 }
-
-// Project 1: 
-//  1) return a vector of mobs that we're colliding with
-//  2) handle collision with towers & river 
-Mob* Mob::checkCollision() 
-{
-    //for (const Mob* pOtherMob : Game::get().getMobs())
-    //{
-    //    if (this == pOtherMob) 
-    //    {
-    //        continue;
-    //    }
-
-    //    // Project 1: YOUR CODE CHECKING FOR A COLLISION GOES HERE
-    //}
-    return NULL;
-}
-
-void Mob::processCollision(Mob* otherMob, float deltaTSec) 
-{
-    // Project 1: YOUR COLLISION HANDLING CODE GOES HERE
-}
-
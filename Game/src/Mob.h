@@ -24,23 +24,90 @@
 
 #include "Entity.h"
 
+class Behavior;
 struct Waypoint;
 
 class Mob : public Entity {
 
 public:
-    Mob(const iEntityStats& stats, const Vec2& pos, bool isNorth);
+    Mob(Game& game, const iEntityStats& stats, const Vec2& pos, bool isNorth);
 
-    virtual void tick(float deltaTSec);
+    // The Game doesn't call this - it ticks the mobs one type at a time, 
+    // with tickAll() (which is what this calls, for just the one mob).
+    virtual void tick(float deltaTSec, IntentBuffer& intents);
+
+    // Ticks numMobs mobs, all of type T, with T's MobBehavior.  These are 
+    // only instantiated in Mob.cpp - use getTickAll() to get the one for a 
+    // type, and then call it for every mob of that type.
+    template <iEntityStats::MobType T>
+    static void tickAll(Mob* const* ppMobs, size_t numMobs, float deltaTSec, IntentBuffer& intents);
+
+    typedef void (*TickAllFn)(Mob* const* ppMobs, size_t numMobs, float deltaTSec, IntentBuffer& intents);
+    static TickAllFn getTickAll(iEntityStats::MobType type);
+
+    // Cached, since it's what everything that batches mobs up sorts on.
+    iEntityStats::MobType getMobType() const { return m_Type; }
+
+    virtual void commit();
 
     virtual bool isHidden() const;
 
+    // Where we'll be at the end of this tick.  The CollisionSolver adjusts
+    // this before it's committed.
+    const Vec2& getNextPosition() const { return m_NextPos; }
+    void setNextPosition(const Vec2& pos) { m_NextPos = pos; }
+
+    // How fast we chose to move last tick (before any collisions).
+    const Vec2& getVelocity() const { return m_Velocity; }
+
+    // Our multi-tick behavior (see MobBehavior::startBehavior()), if our 
+    // type has one and it's still running.  It's owned by the Game's 
+    // BehaviorScheduler, which sets this back to NULL when it finishes.
+    Behavior* getBehavior() const { return m_pBehavior; }
+    void setBehavior(Behavior* pBehavior) { m_pBehavior = pBehavior; }
+
+    // Our behavior is done with once we're dead.  Player::removeDeadMobs()
+    // calls this.
+    void stopBehavior();
+
+    // What our behavior is waiting for (Behavior::WakeEvent bits).  We
+    // check for these as we tick, and push a wake-up when one happens.
+    void setWakeOn(unsigned int events, float range) { m_WakeOn = events; m_WakeRange = range; }
+
+    // Things a behavior can change about how we tick.
+    //  - How fast we move.  Starts as our stats' speed.
+    //  - Whether we hang back (and go wherever our MobBehavior's idle 
+    //    destination is) rather than chase a target that's out of reach.
+    float getSpeed() const { return m_Speed; }
+    void setSpeed(float speed) { m_Speed = speed; }
+    bool isHoldingBack() const { return m_bHoldBack; }
+    void setHoldingBack(bool bHoldBack) { m_bHoldBack = bHoldBack; }
+
 protected:
-    void move(float deltaTSec);
-    const Vec2* pickWaypoint();
-    Mob* checkCollision();
-    void processCollision(Mob* otherMob, float deltaTSec);
+    // Heads for pIdleDest if it's given, and otherwise for our target (if 
+    // it's on our side of the river) or the bridge.
+    void move(float deltaTSec, const Vec2* pIdleDest);
+    bool isTargetOnOurSide() const;
+    Vec2 avoidNeighbors(const Vec2& preferredVelocity, float deltaTSec) const;
+    const Vec2* pickWaypoint(const Vec2& pos);
+
+    // Whether anything our behavior is waiting for happened this tick.
+    bool checkWake(bool bAttacked) const;
 
 private:
+    const iEntityStats::MobType m_Type;
     const Vec2* m_pWaypoint;
+
+    // Where we'll be at the end of this tick.  Other entities keep seeing
+    //  m_Pos until commit() is called.
+    Vec2 m_NextPos;
+
+    Vec2 m_Velocity;
+    Vec2 m_NextVelocity;
+
+    Behavior* m_pBehavior;
+    unsigned int m_WakeOn;
+    float m_WakeRange;
+    float m_Speed;
+    bool m_bHoldBack;
 };
@@ -0,0 +1,179 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MobBehavior.h"
+
+#include "BehaviorScheduler.h"
+#include "Game.h"
+#include "Mob.h"
+#include "MobGrid.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <assert.h>
+
+// Hide until an enemy comes within spring range, then spring at it and 
+// fight it to the death.  After that, catch our breath before hiding again.
+class RogueBehavior : public Behavior
+{
+public:
+    explicit RogueBehavior(Mob& rogue)
+        : Behavior(rogue)
+        , m_State(Hide)
+    {}
+
+    virtual Wait resume(float now)
+    {
+        // How long to wait after a fight before hiding again.
+        static const float ksRecoverSec = 1.f;
+
+        const iEntityStats_Rogue& stats = iEntityStats::getRogueStats();
+        Mob& rogue = getMob();
+
+        switch (m_State)
+        {
+        case Hide:
+            rogue.setHoldingBack(true);
+            m_State = Spring;
+            return Wait::wakeOn(WakeOnTargetInRange, stats.getSpringRange());
+
+        case Spring:
+        {
+            // Out of cover as fast as we can, for one big hit.  If we don't 
+            // land it in about the time it takes to get there (plus a swing),
+            // it's got away, and we just fight.
+            rogue.setHoldingBack(false);
+            rogue.setSpeed(stats.getSpringSpeed());
+            rogue.setAttackDamage((int)stats.getSpringAttackDamage());
+            m_State = Fight;
+            const float springTimeSec = stats.getSpringRange() / stats.getSpringSpeed() + stats.getAttackTime();
+            return Wait::wakeOn(WakeOnAttack).orUntil(now + springTimeSec);
+        }
+
+        case Fight:
+            rogue.setSpeed(stats.getSpeed());
+            rogue.setAttackDamage(stats.getDamage());
+            m_State = Recover;
+            return Wait::wakeOn(WakeOnTargetLost);
+
+        case Recover:
+            m_State = Hide;
+            return Wait::until(now + ksRecoverSec);
+        }
+
+        assert(false && "Unknown Rogue state");
+        return Wait::done();
+    }
+
+private:
+    // What to do when we're next resumed.
+    enum State
+    {
+        Hide,
+        Spring,
+        Fight,
+        Recover,
+    };
+
+    State m_State;
+};
+
+bool MobBehavior<iEntityStats::Rogue>::hasCover(const Mob& rogue, const Game& game)
+{
+    // Cover is a friendly tower that's still standing and that we're right 
+    // up against (within getHideDistance() of its edge), or a friendly Giant 
+    // close by (within perferGiantRange()) that's between us and the enemy.
+    const iEntityStats_Rogue& stats = iEntityStats::getRogueStats();
+    const Player& player = game.getPlayer(rogue.isNorth());
+    const Vec2& pos = rogue.getPosition();
+
+    for (const Entity* pBuilding : player.getBuildings())
+    {
+        const Real reach = Real(pBuilding->getStats().getSize() / 2.f + stats.getHideDistance());
+        if (!pBuilding->isDead() && (pos.distSqr(pBuilding->getPosition()) <= reach * reach))
+            return true;
+    }
+
+    const std::vector<Entity*>& mobs = player.getMobs();
+    const Real towardEnemy = rogue.isNorth() ? Real(1) : Real(-1);
+    uint32_t nearby[MobGrid::ksMaxNearest];
+    const size_t numNearby = std::min(player.getMobIndex().findInCircle(pos, Real(stats.perferGiantRange()), 
+                                                                        nearby, MobGrid::ksMaxNearest),
+                                      MobGrid::ksMaxNearest);
+    for (size_t i = 0; i < numNearby; ++i)
+    {
+        const Entity* pOther = mobs[nearby[i]];
+        if ((pOther->getStats().getMobType() == iEntityStats::Giant)
+            && ((pOther->getPosition().y - pos.y) * towardEnemy >= Real(0)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MobBehavior<iEntityStats::Rogue>::pickIdleDestination(const Mob& rogue, const Game& game, Vec2& dest)
+{
+    // Tuck in behind the nearest friendly Giant, or failing that the nearest
+    // friendly tower.  Either way we're hidden once we get there.
+    const Player& player = game.getPlayer(rogue.isNorth());
+    const Vec2& pos = rogue.getPosition();
+
+    const Entity* pCover = NULL;
+    const int giant = player.getMobIndex().findNearestOfType(pos, iEntityStats::Giant);
+    if (giant >= 0)
+    {
+        pCover = player.getMobs()[giant];
+    }
+    else
+    {
+        Real smallestDistSq = REAL_MAX;
+        for (const Entity* pBuilding : player.getBuildings())
+        {
+            const Real distSq = pos.distSqr(pBuilding->getPosition());
+            if (!pBuilding->isDead() && (distSq < smallestDistSq))
+            {
+                smallestDistSq = distSq;
+                pCover = pBuilding;
+            }
+        }
+    }
+
+    if (!pCover)
+        return false;
+
+    const Real towardEnemy = rogue.isNorth() ? Real(1) : Real(-1);
+    const Real gap = Real((pCover->getStats().getSize() + rogue.getStats().getSize()) / 2.f);
+    dest = pCover->getPosition();
+    dest.y -= towardEnemy * gap;
+
+    // We can't wade across the river, so if our cover is on the other side
+    // follow the waypoints over the bridge first.
+    const Real halfHeight = Real(game.getLayout().getHeight() / 2);
+    return (dest.y < halfHeight) == (pos.y < halfHeight);
+}
+
+Behavior* MobBehavior<iEntityStats::Rogue>::startBehavior(Mob& rogue, BehaviorScheduler& scheduler)
+{
+    return scheduler.start<RogueBehavior>(rogue);
+}
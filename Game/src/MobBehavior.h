@@ -0,0 +1,104 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityStats.h"
+
+#include <stddef.h>
+
+class Behavior;
+class BehaviorScheduler;
+class Game;
+class Mob;
+class Vec2;
+
+// What makes one type of mob act differently from the others.  Everything
+// here is picked at compile time - the Game ticks the mobs one type at a 
+// time (see Mob::tickAll()), so there's no per-mob dispatch, and a type 
+// that doesn't need something costs nothing for it.
+//   This is the default, which covers most types.  Specialize it to give a 
+// type something of its own.
+template <iEntityStats::MobType T>
+struct MobBehavior
+{
+    // Whether mobs of this type can ever be hidden.  If not, 
+    // Game::updateVisibility() doesn't even look at them.
+    static const bool kbCanHide = false;
+
+    // Whether the mob has something to hide behind.  Only called if 
+    // kbCanHide, and only for mobs that haven't locked on to a target.
+    static bool hasCover(const Mob& /*mob*/, const Game& /*game*/) { return false; }
+
+    // Where to go when there's nothing to attack on our side of the river.
+    // Return false to head for the bridge (and the enemy towers).
+    static bool pickIdleDestination(const Mob& /*mob*/, const Game& /*game*/, Vec2& /*dest*/) { return false; }
+
+    // Whether mobs of this type have a multi-tick Behavior.  If not, they 
+    // don't even check for wake-ups as they tick.
+    static const bool kbHasBehavior = false;
+
+    // Starts the behavior for a newly spawned mob (see 
+    // BehaviorScheduler::start()), or returns NULL if it doesn't have one.
+    static Behavior* startBehavior(Mob& /*mob*/, BehaviorScheduler& /*scheduler*/) { return NULL; }
+};
+
+// The Rogue hides - behind a friendly Giant that's between it and the 
+// enemy, or up against a friendly tower - until it attacks.  It doesn't
+// go looking for trouble, either: with nothing to attack it sticks with a 
+// Giant, or waits behind a tower.  Its behavior (see MobBehavior.cpp) 
+// keeps it there until an enemy comes within getSpringRange(), then 
+// springs out at getSpringSpeed() for a getSpringAttackDamage() hit.
+template <>
+struct MobBehavior<iEntityStats::Rogue>
+{
+    static const bool kbCanHide = true;
+    static bool hasCover(const Mob& rogue, const Game& game);
+    static bool pickIdleDestination(const Mob& rogue, const Game& game, Vec2& dest);
+
+    static const bool kbHasBehavior = true;
+    static Behavior* startBehavior(Mob& rogue, BehaviorScheduler& scheduler);
+};
+
+// The types to build the per-type tables from.  It must list every MobType,
+// in the same order as the enum, so that the tables can be indexed by type.
+template <iEntityStats::MobType... Types>
+struct MobTypeList {};
+
+typedef MobTypeList<iEntityStats::Swordsman,
+                    iEntityStats::Archer,
+                    iEntityStats::Giant,
+                    iEntityStats::Rogue> AllMobTypes;
+
+template <iEntityStats::MobType... Types>
+constexpr bool isInMobTypeOrder(MobTypeList<Types...>)
+{
+    const iEntityStats::MobType types[] = { Types... };
+    for (size_t i = 0; i < sizeof...(Types); ++i)
+    {
+        if (types[i] != (iEntityStats::MobType)i)
+            return false;
+    }
+    return sizeof...(Types) == iEntityStats::numMobTypes;
+}
+
+static_assert(isInMobTypeOrder(AllMobTypes()), "AllMobTypes is out of synch with the MobType enum");
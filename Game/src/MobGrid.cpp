@@ -0,0 +1,253 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MobGrid.h"
+
+#include "Mob.h"
+
+#include <algorithm>
+#include <assert.h>
+
+MobGrid::MobGrid(const ArenaLayout& layout)
+    : m_NumCellsX(layout.getWidth() / ksCellSize + 1)
+    , m_NumCellsY(layout.getHeight() / ksCellSize + 1)
+    , m_CellStart(m_NumCellsX * m_NumCellsY + 1, 0)
+{
+}
+
+int MobGrid::getCellX(Real x) const
+{
+    return std::min(std::max((int)(x / Real(ksCellSize)), 0), m_NumCellsX - 1);
+}
+
+int MobGrid::getCellY(Real y) const
+{
+    return std::min(std::max((int)(y / Real(ksCellSize)), 0), m_NumCellsY - 1);
+}
+
+int MobGrid::getCell(Real x, Real y) const
+{
+    return getCellY(y) * m_NumCellsX + getCellX(x);
+}
+
+void MobGrid::build(const std::vector<Mob*>& mobs)
+{
+    // Counting sort by cell, keeping the given order within each cell.
+    const size_t num = mobs.size();
+    const int numCells = m_NumCellsX * m_NumCellsY;
+
+    m_Cell.resize(num);
+    m_CellStart.assign(numCells + 1, 0);
+    for (size_t i = 0; i < num; ++i)
+    {
+        const Vec2& pos = mobs[i]->getPosition();
+        m_Cell[i] = (uint32_t)getCell(pos.x, pos.y);
+        ++m_CellStart[m_Cell[i] + 1];
+    }
+    for (int c = 0; c < numCells; ++c)
+    {
+        m_CellStart[c + 1] += m_CellStart[c];
+    }
+
+    m_Mobs.resize(num);
+    m_X.resize(num);
+    m_Y.resize(num);
+    m_Index.resize(num);
+    m_Cursor.assign(m_CellStart.begin(), m_CellStart.end() - 1);
+    for (size_t i = 0; i < num; ++i)
+    {
+        const uint32_t slot = m_Cursor[m_Cell[i]]++;
+        m_Mobs[slot] = mobs[i];
+        m_X[slot] = mobs[i]->getPosition().x;
+        m_Y[slot] = mobs[i]->getPosition().y;
+        m_Index[slot] = (uint32_t)i;
+    }
+}
+
+size_t MobGrid::findNearest(const Vec2& pos, Real radius, const Mob* pIgnore,
+                            const Mob** pOut, size_t maxCount) const
+{
+    assert(maxCount <= ksMaxNearest);
+    if (maxCount == 0 || m_Mobs.empty())
+        return 0;
+
+    const int minCell = getCell(pos.x - radius, pos.y - radius);
+    const int maxCell = getCell(pos.x + radius, pos.y + radius);
+    const int minX = minCell % m_NumCellsX;
+    const int minY = minCell / m_NumCellsX;
+    const int maxX = maxCell % m_NumCellsX;
+    const int maxY = maxCell / m_NumCellsX;
+    const Real radiusSq = radius * radius;
+
+    // Insertion sort into the output, closest first.  Ties go to the lower
+    // id, so the answer doesn't depend on the order of the grid.
+    Real distSq[ksMaxNearest];
+    size_t count = 0;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            const int cell = y * m_NumCellsX + x;
+            for (uint32_t i = m_CellStart[cell]; i < m_CellStart[cell + 1]; ++i)
+            {
+                const Real dx = m_X[i] - pos.x;
+                const Real dy = m_Y[i] - pos.y;
+                const Real dSq = dx * dx + dy * dy;
+                if (dSq > radiusSq || m_Mobs[i] == pIgnore)
+                    continue;
+
+                const unsigned int id = m_Mobs[i]->getId();
+                size_t slot = count;
+                while (slot > 0 && (dSq < distSq[slot - 1] || 
+                                    (dSq == distSq[slot - 1] && id < pOut[slot - 1]->getId())))
+                {
+                    --slot;
+                }
+                if (slot >= maxCount)
+                    continue;
+
+                const size_t last = std::min(count, maxCount - 1);
+                for (size_t j = last; j > slot; --j)
+                {
+                    distSq[j] = distSq[j - 1];
+                    pOut[j] = pOut[j - 1];
+                }
+                distSq[slot] = dSq;
+                pOut[slot] = m_Mobs[i];
+                count = std::min(count + 1, maxCount);
+            }
+        }
+    }
+
+    return count;
+}
+
+size_t MobGrid::findInCircle(const Vec2& center, Real radius, uint32_t* pOut, size_t maxCount) const
+{
+    const int minX = getCellX(center.x - radius);
+    const int maxX = getCellX(center.x + radius);
+    const int minY = getCellY(center.y - radius);
+    const int maxY = getCellY(center.y + radius);
+    const Real radiusSq = radius * radius;
+
+    size_t count = 0;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        // The cells in a row are next to each other in the arrays.
+        const int rowStart = y * m_NumCellsX;
+        for (uint32_t i = m_CellStart[rowStart + minX]; i < m_CellStart[rowStart + maxX + 1]; ++i)
+        {
+            const Real dx = m_X[i] - center.x;
+            const Real dy = m_Y[i] - center.y;
+            if (dx * dx + dy * dy <= radiusSq)
+            {
+                if (count < maxCount)
+                    pOut[count] = m_Index[i];
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+size_t MobGrid::findInRect(const Vec2& minCorner, const Vec2& maxCorner, uint32_t* pOut, size_t maxCount) const
+{
+    const int minX = getCellX(minCorner.x);
+    const int maxX = getCellX(maxCorner.x);
+    const int minY = getCellY(minCorner.y);
+    const int maxY = getCellY(maxCorner.y);
+
+    size_t count = 0;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const int rowStart = y * m_NumCellsX;
+        for (uint32_t i = m_CellStart[rowStart + minX]; i < m_CellStart[rowStart + maxX + 1]; ++i)
+        {
+            if ((m_X[i] >= minCorner.x) && (m_X[i] <= maxCorner.x) && 
+                (m_Y[i] >= minCorner.y) && (m_Y[i] <= maxCorner.y))
+            {
+                if (count < maxCount)
+                    pOut[count] = m_Index[i];
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+int MobGrid::findNearestOfType(const Vec2& pos, iEntityStats::MobType type) const
+{
+    // Look at rings of cells further and further out, until the next ring 
+    // is too far away to beat the best we've found.
+    const int cx = getCellX(pos.x);
+    const int cy = getCellY(pos.y);
+    const int maxRing = std::max(m_NumCellsX, m_NumCellsY);
+
+    int best = -1;
+    Real bestDistSq(0);
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        if (best >= 0)
+        {
+            // Everything in this ring is at least this far from pos, since
+            // pos is somewhere in the center cell.
+            const Real minDist = Real((ring - 1) * ksCellSize);
+            if (bestDistSq < minDist * minDist)
+                break;
+        }
+
+        for (int y = cy - ring; y <= cy + ring; ++y)
+        {
+            if ((y < 0) || (y >= m_NumCellsY))
+                continue;
+
+            // Only the ends of the row, except on the top and bottom.
+            const bool bEdgeRow = (y == cy - ring) || (y == cy + ring);
+            const int step = bEdgeRow ? 1 : std::max(2 * ring, 1);
+            for (int x = cx - ring; x <= cx + ring; x += step)
+            {
+                if ((x < 0) || (x >= m_NumCellsX))
+                    continue;
+
+                const int cell = y * m_NumCellsX + x;
+                for (uint32_t i = m_CellStart[cell]; i < m_CellStart[cell + 1]; ++i)
+                {
+                    if ((type != iEntityStats::InvalidMobType) && (m_Mobs[i]->getStats().getMobType() != type))
+                        continue;
+
+                    const Real dx = m_X[i] - pos.x;
+                    const Real dy = m_Y[i] - pos.y;
+                    const Real distSq = dx * dx + dy * dy;
+                    if ((best < 0) || (distSq < bestDistSq) || ((distSq == bestDistSq) && ((int)m_Index[i] < best)))
+                    {
+                        best = (int)m_Index[i];
+                        bestDistSq = distSq;
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
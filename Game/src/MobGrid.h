@@ -0,0 +1,91 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "EntityStats.h"
+#include "Vec2.h"
+
+#include <stdint.h>
+#include <vector>
+
+class Mob;
+
+// A uniform grid over where the mobs are at the start of the tick (their 
+// committed positions), for finding the mobs near a point without looking
+// at all of them.  It's built once per tick, before anyone ticks, and only
+// read after that - so it's safe to query from any thread.
+class MobGrid
+{
+public:
+    static const int ksCellSize = 2;            // in meters
+    static const size_t ksMaxNearest = 32;      // most that findNearest() will return
+
+    explicit MobGrid(const ArenaLayout& layout);
+
+    void build(const std::vector<Mob*>& mobs);
+
+    // Fills pOut with the (up to) maxCount mobs closest to pos that are 
+    // within radius of it, nearest first, and returns how many there were.
+    // pIgnore (if not NULL) is skipped, so a mob can look for its neighbors.
+    size_t findNearest(const Vec2& pos, Real radius, const Mob* pIgnore,
+                       const Mob** pOut, size_t maxCount) const;
+
+    // These answer in terms of the vector that was passed to build(): each 
+    // one fills pOut with the indices (in that vector) of up to maxCount 
+    // of the mobs in the circle or rectangle (edges included), in no 
+    // particular order, and returns how many there were in all.
+    size_t findInCircle(const Vec2& center, Real radius, uint32_t* pOut, size_t maxCount) const;
+    size_t findInRect(const Vec2& minCorner, const Vec2& maxCorner, uint32_t* pOut, size_t maxCount) const;
+
+    // The index of the mob of the given type (or any type, for 
+    // InvalidMobType) that's closest to pos, or -1 if there aren't any.  
+    // Ties go to the lower index.
+    int findNearestOfType(const Vec2& pos, iEntityStats::MobType type) const;
+
+private:
+    int getCell(Real x, Real y) const;
+    int getCellX(Real x) const;
+    int getCellY(Real y) const;
+
+private:
+    int m_NumCellsX;
+    int m_NumCellsY;
+
+    // Sorted by cell: cell c's mobs are entries m_CellStart[c] up to 
+    // m_CellStart[c + 1].  The positions are copied in alongside, so a 
+    // query only touches the mobs that it returns.
+    std::vector<uint32_t> m_CellStart;
+    std::vector<const Mob*> m_Mobs;
+    std::vector<Real> m_X;
+    std::vector<Real> m_Y;
+    std::vector<uint32_t> m_Index;      // where each one was in build()'s vector
+
+    std::vector<uint32_t> m_Cell;       // scratch for the sort
+    std::vector<uint32_t> m_Cursor;
+
+private:
+    // DELIBERATELY UNDEFINED
+    MobGrid(const MobGrid& rhs);
+    MobGrid& operator=(const MobGrid& rhs);
+};
@@ -0,0 +1,294 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "OrcaSteering.h"
+
+#include <algorithm>
+
+const float OrcaSteering::ksTimeHorizon = 0.5f;
+
+// Below this, lines count as parallel.  It's coarse enough to mean the same
+// thing in fixed point.
+static const float ksEpsilon = 0.001f;
+
+static Real det(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+static Real dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+
+void OrcaSteering::Lines::add(const Vec2& point, const Vec2& dir)
+{
+    m_PointX[m_Count] = point.x;
+    m_PointY[m_Count] = point.y;
+    m_DirX[m_Count] = dir.x;
+    m_DirY[m_Count] = dir.y;
+    ++m_Count;
+}
+
+OrcaSteering::OrcaSteering(const Vec2& pos, const Vec2& velocity, Real radius)
+    : m_Pos(pos)
+    , m_Velocity(velocity)
+    , m_Radius(radius)
+    , m_NumNeighbors(0)
+{
+    m_Lines.m_Count = 0;
+}
+
+bool OrcaSteering::addNeighbor(const Vec2& pos, const Vec2& velocity, Real radius, bool bMoving)
+{
+    if (m_NumNeighbors >= ksMaxNeighbors)
+        return false;
+
+    Neighbor& n = m_Neighbors[m_NumNeighbors++];
+    n.m_Pos = pos;
+    n.m_Velocity = velocity;
+    n.m_Radius = radius;
+    n.m_Responsibility = bMoving ? Real(0.5f) : Real(1);
+    return true;
+}
+
+Vec2 OrcaSteering::solve(const Vec2& preferredVelocity, Real maxSpeed, float deltaTSec)
+{
+    const Real invDeltaT = Real(1) / Real(deltaTSec);
+    m_Lines.m_Count = 0;
+    for (int i = 0; i < m_NumNeighbors; ++i)
+    {
+        const Neighbor& n = m_Neighbors[i];
+        addConstraint(n.m_Pos, n.m_Velocity, n.m_Radius, n.m_Responsibility, invDeltaT);
+    }
+
+    Vec2 result;
+    const int failed = solveAll(m_Lines, maxSpeed, preferredVelocity, false, result);
+    if (failed < m_Lines.m_Count)
+    {
+        solveLeastViolating(failed, maxSpeed, result);
+    }
+    return result;
+}
+
+void OrcaSteering::addConstraint(const Vec2& pos, const Vec2& velocity, Real radius, 
+                                 Real responsibility, Real invDeltaT)
+{
+    const Real invTimeHorizon = Real(1) / Real(ksTimeHorizon);
+    const Vec2 relPos = pos - m_Pos;
+    const Vec2 relVel = m_Velocity - velocity;
+    const Real distSq = relPos.lengthSqr();
+    const Real combinedRadius = m_Radius + radius;
+    const Real combinedRadiusSq = combinedRadius * combinedRadius;
+
+    Vec2 dir;
+    Vec2 u;
+    if (distSq > combinedRadiusSq)
+    {
+        // Not touching yet.  The velocity obstacle is a cone, truncated at 
+        // the time horizon, and u is the smallest change in our relative 
+        // velocity that gets us out of it.
+        const Vec2 w = relVel - relPos * invTimeHorizon;
+        const Real wLengthSq = w.lengthSqr();
+        const Real dotProduct = dot(w, relPos);
+
+        if (dotProduct < Real(0) && dotProduct * dotProduct > combinedRadiusSq * wLengthSq)
+        {
+            // Closest to the rounded end of the cone.
+            Vec2 unitW = w;
+            const Real wLength = unitW.normalize();
+            dir = Vec2(unitW.y, -unitW.x);
+            u = unitW * (combinedRadius * invTimeHorizon - wLength);
+        }
+        else
+        {
+            // Closest to one of the sides (legs) of the cone.
+            const Real leg = sqrt(distSq - combinedRadiusSq);
+            if (det(relPos, w) > Real(0))
+            {
+                dir = Vec2(relPos.x * leg - relPos.y * combinedRadius,
+                           relPos.x * combinedRadius + relPos.y * leg) / distSq;
+            }
+            else
+            {
+                dir = Vec2(relPos.x * leg + relPos.y * combinedRadius,
+                           relPos.y * leg - relPos.x * combinedRadius) / distSq * Real(-1);
+            }
+            u = dir * dot(relVel, dir) - relVel;
+        }
+    }
+    else
+    {
+        // Already overlapping, so get apart by the end of this tick.  If 
+        // we're right on top of each other there's no way to tell which way
+        // is apart, so just don't constrain it (the CollisionSolver will 
+        // sort it out).
+        const Vec2 w = relVel - relPos * invDeltaT;
+        Vec2 unitW = w;
+        const Real wLength = unitW.normalize();
+        if (wLength <= Real(ksEpsilon))
+            return;
+
+        dir = Vec2(unitW.y, -unitW.x);
+        u = unitW * (combinedRadius * invDeltaT - wLength);
+    }
+
+    m_Lines.add(m_Velocity + u * responsibility, dir);
+}
+
+// The best velocity on line lineNo that satisfies all of the lines before 
+// it and is no faster than maxSpeed.  If bDirectionOpt then optVelocity is
+// a direction to go as far as possible in, rather than a velocity to get
+// close to.
+bool OrcaSteering::solveOnLine(const Lines& lines, int lineNo, Real maxSpeed, 
+                               const Vec2& optVelocity, bool bDirectionOpt, Vec2& result)
+{
+    const Vec2 point = lines.getPoint(lineNo);
+    const Vec2 dir = lines.getDir(lineNo);
+
+    // Where the line crosses the max speed circle.
+    const Real dotProduct = dot(point, dir);
+    const Real discriminant = dotProduct * dotProduct + maxSpeed * maxSpeed - point.lengthSqr();
+    if (discriminant < Real(0))
+        return false;
+
+    const Real sqrtDiscriminant = sqrt(discriminant);
+    Real tLeft = Real(0) - dotProduct - sqrtDiscriminant;
+    Real tRight = sqrtDiscriminant - dotProduct;
+
+    // Clip it against the earlier lines.
+    for (int i = 0; i < lineNo; ++i)
+    {
+        const Real denominator = det(dir, lines.getDir(i));
+        const Real numerator = det(lines.getDir(i), point - lines.getPoint(i));
+
+        if (std::max(denominator, Real(0) - denominator) <= Real(ksEpsilon))
+        {
+            // Parallel.  Either all of this line is allowed or none of it is.
+            if (numerator < Real(0))
+                return false;
+            continue;
+        }
+
+        const Real t = numerator / denominator;
+        if (denominator >= Real(0))
+            tRight = std::min(tRight, t);
+        else
+            tLeft = std::max(tLeft, t);
+
+        if (tLeft > tRight)
+            return false;
+    }
+
+    if (bDirectionOpt)
+    {
+        result = point + dir * ((dot(optVelocity, dir) > Real(0)) ? tRight : tLeft);
+    }
+    else
+    {
+        const Real t = dot(dir, optVelocity - point);
+        result = point + dir * std::min(std::max(t, tLeft), tRight);
+    }
+    return true;
+}
+
+// Incremental 2D linear program: start from the best unconstrained answer 
+// and, for each line it violates, move to the best answer on that line.  
+// Returns the first line that couldn't be satisfied (or the number of lines
+// if they all were).
+int OrcaSteering::solveAll(const Lines& lines, Real maxSpeed, const Vec2& optVelocity, 
+                           bool bDirectionOpt, Vec2& result)
+{
+    if (bDirectionOpt)
+    {
+        result = optVelocity * maxSpeed;
+    }
+    else if (optVelocity.lengthSqr() > maxSpeed * maxSpeed)
+    {
+        result = optVelocity;
+        result.normalize();
+        result *= maxSpeed;
+    }
+    else
+    {
+        result = optVelocity;
+    }
+
+    for (int i = 0; i < lines.m_Count; ++i)
+    {
+        if (det(lines.getDir(i), lines.getPoint(i) - result) > Real(0))
+        {
+            const Vec2 previous = result;
+            if (!solveOnLine(lines, i, maxSpeed, optVelocity, bDirectionOpt, result))
+            {
+                result = previous;
+                return i;
+            }
+        }
+    }
+
+    return lines.m_Count;
+}
+
+// There's no velocity that satisfies everyone, so find the one that 
+// minimizes the worst violation (a 3D linear program, solved as a series of
+// 2D ones along each offending line).
+void OrcaSteering::solveLeastViolating(int firstFailed, Real maxSpeed, Vec2& result) const
+{
+    Real distance = Real(0);
+    for (int i = firstFailed; i < m_Lines.m_Count; ++i)
+    {
+        const Vec2 pointI = m_Lines.getPoint(i);
+        const Vec2 dirI = m_Lines.getDir(i);
+        if (det(dirI, pointI - result) <= distance)
+            continue;
+
+        // The lines before this one, projected onto it.
+        Lines projected;
+        projected.m_Count = 0;
+        for (int j = 0; j < i; ++j)
+        {
+            const Vec2 pointJ = m_Lines.getPoint(j);
+            const Vec2 dirJ = m_Lines.getDir(j);
+            const Real determinant = det(dirI, dirJ);
+
+            Vec2 point;
+            if (std::max(determinant, Real(0) - determinant) <= Real(ksEpsilon))
+            {
+                if (dot(dirI, dirJ) > Real(0))
+                    continue;       // same direction, so j adds nothing
+                point = (pointI + pointJ) * Real(0.5f);
+            }
+            else
+            {
+                point = pointI + dirI * (det(dirJ, pointI - pointJ) / determinant);
+            }
+
+            Vec2 dir = dirJ - dirI;
+            dir.normalize();
+            projected.add(point, dir);
+        }
+
+        const Vec2 previous = result;
+        if (solveAll(projected, maxSpeed, Vec2(Real(0) - dirI.y, dirI.x), true, result) < projected.m_Count)
+        {
+            // Can only fail from rounding error, in which case the last 
+            // answer is as good as any.
+            result = previous;
+        }
+
+        distance = det(dirI, pointI - result);
+    }
+}
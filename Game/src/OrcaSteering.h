@@ -0,0 +1,100 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Vec2.h"
+
+// Picks a velocity for one mob that won't run it into its neighbors within
+// the time horizon, using Optimal Reciprocal Collision Avoidance (van den 
+// Berg et al., "Reciprocal n-Body Collision Avoidance").  Each neighbor 
+// rules out a half-plane of velocities, and we take the velocity closest to
+// the one we'd like that's in all of them (a small 2D linear program).  If 
+// there isn't one (it's too crowded), we take the one that violates them 
+// the least.
+//
+// Moving neighbors are assumed to do half of the avoiding (since they're 
+// doing the same thing), and ones that are standing still none of it.
+//
+// Usage:
+//     OrcaSteering steering(myPos, myVelocity, myRadius);
+//     steering.addNeighbor(...);       // up to ksMaxNeighbors times
+//     Vec2 vel = steering.solve(preferredVelocity, maxSpeed, deltaTSec);
+class OrcaSteering
+{
+public:
+    // Bounds the cost per mob, no matter how crowded it gets.
+    static const int ksMaxNeighbors = 8;
+
+    // How far ahead (in seconds) we look for collisions.
+    static const float ksTimeHorizon;
+
+    OrcaSteering(const Vec2& pos, const Vec2& velocity, Real radius);
+
+    // Returns false (and ignores the neighbor) once we have ksMaxNeighbors.
+    bool addNeighbor(const Vec2& pos, const Vec2& velocity, Real radius, bool bMoving);
+
+    Vec2 solve(const Vec2& preferredVelocity, Real maxSpeed, float deltaTSec);
+
+private:
+    // The constraints, each a line (a point and a direction), with the 
+    // permitted velocities to the left of it.  Stored by component, since 
+    // the solver runs down one component at a time.
+    struct Lines
+    {
+        Real m_PointX[ksMaxNeighbors];
+        Real m_PointY[ksMaxNeighbors];
+        Real m_DirX[ksMaxNeighbors];
+        Real m_DirY[ksMaxNeighbors];
+        int m_Count;
+
+        Vec2 getPoint(int i) const { return Vec2(m_PointX[i], m_PointY[i]); }
+        Vec2 getDir(int i) const { return Vec2(m_DirX[i], m_DirY[i]); }
+        void add(const Vec2& point, const Vec2& dir);
+    };
+
+    void addConstraint(const Vec2& pos, const Vec2& velocity, Real radius, 
+                       Real responsibility, Real invDeltaT);
+
+    static bool solveOnLine(const Lines& lines, int lineNo, Real maxSpeed, 
+                            const Vec2& optVelocity, bool bDirectionOpt, Vec2& result);
+    static int solveAll(const Lines& lines, Real maxSpeed, const Vec2& optVelocity, 
+                        bool bDirectionOpt, Vec2& result);
+    void solveLeastViolating(int firstFailed, Real maxSpeed, Vec2& result) const;
+
+private:
+    Vec2 m_Pos;
+    Vec2 m_Velocity;
+    Real m_Radius;
+
+    struct Neighbor
+    {
+        Vec2 m_Pos;
+        Vec2 m_Velocity;
+        Real m_Radius;
+        Real m_Responsibility;
+    };
+    Neighbor m_Neighbors[ksMaxNeighbors];
+    int m_NumNeighbors;
+
+    Lines m_Lines;
+};
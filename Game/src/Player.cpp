@@ -28,17 +28,26 @@
 #include "Game.h"
 #include "Mob.h"
 
-Player::Player(iController* pControl, bool bNorth)
-    : m_pControl(pControl)
+#include <chrono>
+
+Player::Player(Game& game, iController* pControl, bool bNorth)
+    : m_Game(game)
+    , m_pControl(pControl)
     , m_bNorth(bNorth)
     , m_Elixir(capElixir(STARTING_ELIXIR))
+    , m_bStressMode(false)
+    , m_Influence(game.getLayout())
+    , m_MobIndex(game.getLayout())
 {
     buildBuildings();
+    buildLegalTiles();
 
     // for now, all mob types are available.
+    m_AvailableMask = 0;
     for (size_t i = 0; i < iEntityStats::numMobTypes; ++i)
     {
         m_AvailableMobs.push_back((iEntityStats::MobType)i);
+        m_AvailableMask |= 1u << i;
     }
 
     if (m_pControl)
@@ -55,6 +64,43 @@ Player::~Player()
 
 iPlayer::PlacementResult Player::placeMob(iEntityStats::MobType type, const Vec2& pos)
 {
+    return place(type, pos);
+}
+
+unsigned int Player::queuePlacement(iEntityStats::MobType type, const Vec2& pos)
+{
+    QueuedPlacement p = { type, pos };
+    m_QueuedPlacements.push_back(p);
+    return (unsigned int)(m_QueuedPlacements.size() - 1);
+}
+
+void Player::applyPlacements()
+{
+    // The last batch's results stay put until there's a new batch, even if
+    // our controller didn't get to tick (see ControllerBudget).
+    if (m_QueuedPlacements.empty())
+        return;
+
+    // Reuse the vectors, so that a controller that queues about the same 
+    // number every tick doesn't allocate.
+    m_PlacementResults.clear();
+    for (const QueuedPlacement& p : m_QueuedPlacements)
+    {
+        m_PlacementResults.push_back(place(p.m_Type, p.m_Pos));
+    }
+    m_QueuedPlacements.clear();
+}
+
+iPlayer::PlacementResult Player::place(iEntityStats::MobType type, const Vec2& pos)
+{
+    if (m_bStressMode)
+    {
+        // Not snapped to tiles, either, since there may be hundreds going
+        // down in the same place.
+        m_Mobs.push_back(new Mob(m_Game, iEntityStats::getStats(type), pos, m_bNorth));
+        return Success;
+    }
+
     // Adjust the position to be a tile center.  Tiles are 1 unit wide.
     // TODO: move the code for converting to tile position somewhere shared
     const int iTileX = (int)pos.x;
@@ -64,33 +110,33 @@ iPlayer::PlacementResult Player::placeMob(iEntityStats::MobType type, const Vec2
     Vec2 tilePos(fTileX, fTileY);
 
     // Validate the position
-    // TODO: move this functionality somewhere shared.
-    if ((tilePos.x <= 0) || (tilePos.x >= GAME_GRID_WIDTH))
+    const ArenaLayout& layout = getLayout();
+    const bool bValidX = (iTileX >= 0) && (iTileX < layout.getWidth());
+    if (!bValidX)
     {
-        std::cout << "Invalid Location (X): (" << tilePos.x << ", " <<
-            tilePos.y << ")\n";
+        if (m_Game.isLogging())
+            std::cout << "Invalid Location (X): (" << tilePos.x << ", " <<
+                tilePos.y << ")\n";
         return InvalidX;
     }
 
-    if (m_bNorth)
+    if (!isLegalTile(iTileX, iTileY))
     {
-        if (tilePos.y >= RIVER_TOP_Y)
-        {
+        if (m_Game.isLogging())
             std::cout << "Invalid Location (Y): (" << tilePos.x << ", " <<
                 tilePos.y << ")\n";
 
-            return InvalidY;
-        }
+        return InvalidY;
     }
-    else
+
+    // Queued placements can come from anywhere (e.g. over the network), so
+    // make sure it's a real mob type before we look up its cost.
+    if ((unsigned int)type >= iEntityStats::numMobTypes)
     {
-        if (tilePos.y <= RIVER_BOT_Y)
-        {
-            std::cout << "Invalid Location (Y): (" << tilePos.x << ", " <<
-                tilePos.y << ")\n";
+        if (m_Game.isLogging())
+            std::cout << "Mob type not available\n";
 
-            return InvalidY;
-        }
+        return MobTypeUnavailable;
     }
 
     // Validate that we have enough elixir
@@ -98,48 +144,164 @@ iPlayer::PlacementResult Player::placeMob(iEntityStats::MobType type, const Vec2
     const float cost = stats.getElixirCost();
     if (cost > m_Elixir)
     {
-        std::cout << "Insufficient Elixir: " << cost << " > " << m_Elixir <<
-            std::endl;
+        if (m_Game.isLogging())
+            std::cout << "Insufficient Elixir: " << cost << " > " << m_Elixir <<
+                std::endl;
 
         return InsufficientElixir;
     }
 
     // Make sure that the mob type is one that's currently available
-    if (std::find(m_AvailableMobs.begin(), m_AvailableMobs.end(), type) == m_AvailableMobs.end())
+    if (!(m_AvailableMask & (1u << type)))
     {
-        std::cout << "Mob type not available\n";
+        if (m_Game.isLogging())
+            std::cout << "Mob type not available\n";
 
         return MobTypeUnavailable;
     }
 
     // Checks are done - make the mob.
     m_Elixir -= cost;
-    Mob* pMob = new Mob(stats, tilePos, m_bNorth);
+    Mob* pMob = new Mob(m_Game, stats, tilePos, m_bNorth);
     m_Mobs.push_back(pMob);
 
     return Success;
 }
 
-void Player::tick(float deltaTSec)
+void Player::buildLegalTiles()
+{
+    // ArenaLayout::isValidPlacementX() and Y() for every tile center, so 
+    // that checking a placement is a single lookup.
+    const ArenaLayout& layout = getLayout();
+    const int numTiles = layout.getWidth() * layout.getHeight();
+    m_LegalTiles.assign((numTiles + 63) / 64, 0);
+    for (int y = 0; y < layout.getHeight(); ++y)
+    {
+        for (int x = 0; x < layout.getWidth(); ++x)
+        {
+            const Real centerX = Real((float)x + 0.5f);
+            const Real centerY = Real((float)y + 0.5f);
+            if (layout.isValidPlacementX(centerX) && layout.isValidPlacementY(centerY, m_bNorth))
+            {
+                const int i = (y * layout.getWidth()) + x;
+                m_LegalTiles[i / 64] |= (uint64_t)1 << (i % 64);
+            }
+        }
+    }
+}
+
+bool Player::isLegalTile(int x, int y) const
+{
+    const ArenaLayout& layout = getLayout();
+    if ((x < 0) || (x >= layout.getWidth()) || (y < 0) || (y >= layout.getHeight()))
+        return false;
+
+    const int i = (y * layout.getWidth()) + x;
+    return (m_LegalTiles[i / 64] >> (i % 64)) & 1;
+}
+
+void Player::tickController(float deltaTSec)
 {
     m_Elixir += deltaTSec * ELIXIR_PER_SECOND;
     m_Elixir = std::min(m_Elixir, 10.f);
 
-    if (m_pControl)
+    // The controller runs inline, so a slow one holds up the whole match.
+    // Time it, and make it sit out ticks if it's over budget.
+    if (m_pControl && m_Budget.shouldTick())
+    {
+        using namespace std::chrono;
+        const steady_clock::time_point start = steady_clock::now();
         m_pControl->tick(deltaTSec);
-
-    for (Entity* pBuilding : m_Buildings) {
-        if (!pBuilding->isDead()) {
-            pBuilding->tick(deltaTSec);
-        }
+        m_Budget.record(duration<float>(steady_clock::now() - start).count());
     }
+}
+
+void Player::think(std::chrono::steady_clock::time_point deadline)
+{
+    if (!m_pControl || m_Budget.hasForfeited())
+        return;
 
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    if (start >= deadline)
+        return;
+
+    m_pControl->think(deadline);
+    m_Budget.recordThink(duration<float>(deadline - start).count(), 
+                         duration<float>(steady_clock::now() - start).count());
+}
+
+void Player::commitEntities()
+{
     for (Entity* m : m_Mobs) {
         if (!m->isDead()) {
-            m->tick(deltaTSec);
+            m->commit();
         }
     }
+}
+
+unsigned int Player::findMobsInCircle(bool bOpponent, const Vec2& center, float radius, 
+                                      unsigned int* pOut, unsigned int maxCount) const
+{
+    const Player& player = bOpponent ? GetOpponent() : *this;
+    return (unsigned int)player.m_MobIndex.findInCircle(center, Real(radius), pOut, maxCount);
+}
+
+unsigned int Player::findMobsInRect(bool bOpponent, const Vec2& minCorner, const Vec2& maxCorner, 
+                                    unsigned int* pOut, unsigned int maxCount) const
+{
+    const Player& player = bOpponent ? GetOpponent() : *this;
+    return (unsigned int)player.m_MobIndex.findInRect(minCorner, maxCorner, pOut, maxCount);
+}
+
+int Player::findNearestOpponentMob(const Vec2& pos, iEntityStats::MobType type) const
+{
+    return GetOpponent().m_MobIndex.findNearestOfType(pos, type);
+}
+
+void Player::buildMobIndex()
+{
+    m_IndexedMobs.clear();
+    for (Entity* pMob : m_Mobs)
+    {
+        m_IndexedMobs.push_back(static_cast<Mob*>(pMob));
+    }
+    m_MobIndex.build(m_IndexedMobs);
+}
 
+void Player::updateInfluence()
+{
+    for (Entity* pBuilding : m_Buildings) {
+        m_Influence.update(pBuilding->getInfluenceStamp(), pBuilding->getStats(), 
+                           pBuilding->getPosition(), pBuilding->getHealth());
+    }
+    for (Entity* pMob : m_Mobs) {
+        m_Influence.update(pMob->getInfluenceStamp(), pMob->getStats(), 
+                           pMob->getPosition(), pMob->getHealth());
+    }
+}
+
+void Player::computeInfluence(InfluenceMap& map) const
+{
+    const ArenaLayout& layout = getLayout();
+    if ((map.getWidth() == layout.getWidth()) && (map.getHeight() == layout.getHeight()))
+        map.clear();
+    else
+        map = InfluenceMap(layout);
+
+    InfluenceMap::Stamp stamp;
+    for (const std::vector<Entity*>* pList : { &m_Buildings, &m_Mobs })
+    {
+        for (const Entity* pEntity : *pList)
+        {
+            stamp = InfluenceMap::Stamp();
+            map.update(stamp, pEntity->getStats(), pEntity->getPosition(), pEntity->getHealth());
+        }
+    }
+}
+
+void Player::removeDeadMobs()
+{
     // Move any mobs that died this tick into m_DeadMobs
     size_t newIndex = 0;
     for (size_t oldIndex = 0; oldIndex < m_Mobs.size(); ++oldIndex)
@@ -154,6 +316,7 @@ void Player::tick(float deltaTSec)
         }
         else
         {
+            static_cast<Mob*>(pMob)->stopBehavior();
             m_DeadMobs.push_back(m_Mobs[oldIndex]);
         }
     }
@@ -207,23 +370,20 @@ void Player::buildBuildings()
     const iEntityStats& kingStats = iEntityStats::getBuildingStats(iEntityStats::King);
     const iEntityStats& princessStats = iEntityStats::getBuildingStats(iEntityStats::Princess);
 
-    if (m_bNorth)
-    {
-        m_Buildings.push_back(new Building(kingStats, Vec2(KingX, NorthKingY), true));
-        m_Buildings.push_back(new Building(princessStats, Vec2(PrincessLeftX, NorthPrincessY), true));
-        m_Buildings.push_back(new Building(princessStats, Vec2(PrincessRightX, NorthPrincessY), true));
-    }
-    else
-    {
-        m_Buildings.push_back(new Building(kingStats, Vec2(KingX, SouthKingY), false));
-        m_Buildings.push_back(new Building(princessStats, Vec2(PrincessLeftX, SouthPrincessY), false));
-        m_Buildings.push_back(new Building(princessStats, Vec2(PrincessRightX, SouthPrincessY), false));
-    }
+    const ArenaLayout& layout = getLayout();
+    m_Buildings.push_back(new Building(m_Game, kingStats, layout.getKingPos(m_bNorth), m_bNorth));
+    m_Buildings.push_back(new Building(m_Game, princessStats, layout.getPrincessPos(m_bNorth, true), m_bNorth));
+    m_Buildings.push_back(new Building(m_Game, princessStats, layout.getPrincessPos(m_bNorth, false), m_bNorth));
+}
+
+const ArenaLayout& Player::getLayout() const
+{
+    return m_Game.getLayout();
 }
 
 const Player& Player::GetOpponent() const
 {
-    const Player& opPlayer = Game::get().getPlayer(!m_bNorth);
+    const Player& opPlayer = m_Game.getPlayer(!m_bNorth);
     assert(&opPlayer != this);
     return opPlayer;
 }
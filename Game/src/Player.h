@@ -25,25 +25,49 @@
 #include "iPlayer.h"
 
 #include "Constants.h"
+#include "ControllerBudget.h"
+#include "MobGrid.h"
 #include <algorithm>
 #include <assert.h>
+#include <chrono>
+#include <stdint.h>
 
 class iController;
 class Entity;
+class Game;
+class Mob;
 
 class Player : public iPlayer {
 public:
     // NOTE: we take ownership of the controller
-    explicit Player(iController* pControl, bool bNorth);
+    explicit Player(Game& game, iController* pControl, bool bNorth);
     virtual ~Player();
 
     virtual bool isNorth() const { return m_bNorth; }
+    virtual const ArenaLayout& getLayout() const;
 
     virtual float getElixir() const { return (float)m_Elixir; }
+    void setElixir(float elixir) { m_Elixir = elixir; }
     virtual const std::vector<iEntityStats::MobType>& GetAvailableMobTypes() const { return m_AvailableMobs; }
     virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos);
+    virtual unsigned int queuePlacement(iEntityStats::MobType type, const Vec2& pos);
+    virtual const std::vector<PlacementResult>& getPlacementResults() const { return m_PlacementResults; }
 
-    void tick(float deltaTSec);
+    // For stress testing: placeMob() puts mobs exactly where it's asked to,
+    // and doesn't check the location, the elixir, or the mob type.
+    void setStressMode(bool bStressMode) { m_bStressMode = bStressMode; }
+
+    // The Game ticks the players in phases, so that neither side gets to 
+    // act first (see Game::tick()).
+    void tickController(float deltaTSec);
+    void think(std::chrono::steady_clock::time_point deadline);
+    void applyPlacements();
+    void commitEntities();
+    void removeDeadMobs();
+
+    // How long our controller has been taking to tick, and its limits.
+    ControllerBudget& getBudget() { return m_Budget; }
+    const ControllerBudget& getBudget() const { return m_Budget; }
 
     const std::vector<Entity*>& getBuildings() const { return m_Buildings; }
     const std::vector<Entity*>& getMobs() const { return m_Mobs; }
@@ -60,20 +84,66 @@ public:
     virtual unsigned int getNumOpponentMobs() const { return GetOpponent().getNumMobs(); }
     virtual EntityData getOpponentMob(unsigned int i) const;
 
+    virtual unsigned int findMobsInCircle(bool bOpponent, const Vec2& center, float radius, 
+                                          unsigned int* pOut, unsigned int maxCount) const;
+    virtual unsigned int findMobsInRect(bool bOpponent, const Vec2& minCorner, const Vec2& maxCorner, 
+                                        unsigned int* pOut, unsigned int maxCount) const;
+    virtual int findNearestOpponentMob(const Vec2& pos, iEntityStats::MobType type) const;
+
+    // Rebuilds the index that the queries above use.  The Game calls this
+    // at the end of every tick, once the dead have been removed.
+    void buildMobIndex();
+    const MobGrid& getMobIndex() const { return m_MobIndex; }
+
+    virtual const InfluenceMap& getInfluence() const { return m_Influence; }
+    virtual const InfluenceMap& getOpponentInfluence() const { return GetOpponent().getInfluence(); }
+
+    // Brings our InfluenceMap up to date with our entities.  Only the ones 
+    // that changed tile or health (or spawned, or died) since the last call
+    // cost anything.
+    void updateInfluence();
+
+    // Adds up our InfluenceMap from scratch into map, for checking (and 
+    // timing) updateInfluence() against.
+    void computeInfluence(InfluenceMap& map) const;
+
 private:
+    struct QueuedPlacement
+    {
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
     void buildBuildings();
 
+    // placeMob() without the virtual call, so that applyPlacements() can 
+    // go through a batch quickly.
+    PlacementResult place(iEntityStats::MobType type, const Vec2& pos);
+
+    // m_LegalTiles has a bit for each tile (row by row), which is set if 
+    // we're allowed to place mobs there.
+    void buildLegalTiles();
+    bool isLegalTile(int x, int y) const;
+
     const Player& GetOpponent() const;
 
     float capElixir(float e) const { return std::max(e, MAX_ELIXIR); }
 
 private:
+    Game& m_Game;
     iController* m_pControl;                // owned, may be NULL
+    ControllerBudget m_Budget;
 
     bool m_bNorth;
     float m_Elixir;
+    bool m_bStressMode;
 
     std::vector<iEntityStats::MobType> m_AvailableMobs;
+    uint32_t m_AvailableMask;               // bit n => m_AvailableMobs has MobType n
+    std::vector<uint64_t> m_LegalTiles;
+
+    std::vector<QueuedPlacement> m_QueuedPlacements;
+    std::vector<PlacementResult> m_PlacementResults;
 
     std::vector<Entity*> m_Buildings;       // owned
     std::vector<Entity*> m_Mobs;            // owned
@@ -82,4 +152,10 @@ private:
     // them forever - we never delete them - so as to avoid memory issues.
     std::vector<Entity*> m_DeadMobs;        // owned
 
+    InfluenceMap m_Influence;
+
+    // Our mobs (in the same order as m_Mobs) as of the end of the last tick.
+    MobGrid m_MobIndex;
+    std::vector<Mob*> m_IndexedMobs;        // scratch for building it
+
 };
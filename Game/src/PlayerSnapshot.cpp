@@ -0,0 +1,141 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PlayerSnapshot.h"
+
+#include "Constants.h"
+
+#include <algorithm>
+
+PlayerSnapshot::PlayerSnapshot()
+    : m_Tick(0)
+    , m_DeltaTSec(0.f)
+    , m_bNorth(false)
+    , m_Elixir(0.f)
+{
+}
+
+void PlayerSnapshot::capture(const iPlayer& player, unsigned int tick, float deltaTSec)
+{
+    m_Tick = tick;
+    m_DeltaTSec = deltaTSec;
+    m_bNorth = player.isNorth();
+    m_Layout = player.getLayout();
+    m_Elixir = player.getElixir();
+    m_AvailableMobs = player.GetAvailableMobTypes();
+    m_Influence = player.getInfluence();
+    m_OpponentInfluence = player.getOpponentInfluence();
+    m_Placements.clear();
+    m_PlacementResults.clear();
+
+    for (int list = 0; list < numLists; ++list)
+    {
+        m_Lists[list].clear();
+    }
+
+    Entity e;
+    for (unsigned int i = 0; i < player.getNumBuildings(); ++i)
+    {
+        const EntityData data = player.getBuilding(i);
+        e.m_pStats = &data.m_Stats; e.m_Health = data.m_Health; e.m_Pos = data.m_Position;
+        m_Lists[MyBuildings].push_back(e);
+    }
+    for (unsigned int i = 0; i < player.getNumMobs(); ++i)
+    {
+        const EntityData data = player.getMob(i);
+        e.m_pStats = &data.m_Stats; e.m_Health = data.m_Health; e.m_Pos = data.m_Position;
+        m_Lists[MyMobs].push_back(e);
+    }
+    for (unsigned int i = 0; i < player.getNumOpponentBuildings(); ++i)
+    {
+        const EntityData data = player.getOpponentBuilding(i);
+        e.m_pStats = &data.m_Stats; e.m_Health = data.m_Health; e.m_Pos = data.m_Position;
+        m_Lists[TheirBuildings].push_back(e);
+    }
+    for (unsigned int i = 0; i < player.getNumOpponentMobs(); ++i)
+    {
+        const EntityData data = player.getOpponentMob(i);
+        e.m_pStats = &data.m_Stats; e.m_Health = data.m_Health; e.m_Pos = data.m_Position;
+        m_Lists[TheirMobs].push_back(e);
+    }
+}
+
+void PlayerSnapshot::swap(PlayerSnapshot& rhs)
+{
+    std::swap(m_Tick, rhs.m_Tick);
+    std::swap(m_DeltaTSec, rhs.m_DeltaTSec);
+    std::swap(m_bNorth, rhs.m_bNorth);
+    std::swap(m_Layout, rhs.m_Layout);
+    std::swap(m_Elixir, rhs.m_Elixir);
+    m_AvailableMobs.swap(rhs.m_AvailableMobs);
+    for (int list = 0; list < numLists; ++list)
+    {
+        m_Lists[list].swap(rhs.m_Lists[list]);
+    }
+    m_Influence.swap(rhs.m_Influence);
+    m_OpponentInfluence.swap(rhs.m_OpponentInfluence);
+    m_Placements.swap(rhs.m_Placements);
+    m_PlacementResults.swap(rhs.m_PlacementResults);
+}
+
+iPlayer::EntityData PlayerSnapshot::get(List list, unsigned int i) const
+{
+    if (i < m_Lists[list].size())
+    {
+        const Entity& e = m_Lists[list][i];
+        return EntityData(*e.m_pStats, e.m_Health, e.m_Pos);
+    }
+
+    return EntityData();
+}
+
+iPlayer::PlacementResult PlayerSnapshot::placeMob(iEntityStats::MobType type, const Vec2& pos)
+{
+    // These are the same checks (in the same order) as Player::placeMob(), 
+    // so the answer we give now is the answer the game will give later 
+    // (unless something changes in between).
+    const Real tileX = Real((int)pos.x) + Real(0.5f);
+    const Real tileY = Real((int)pos.y) + Real(0.5f);
+    if (!m_Layout.isValidPlacementX(tileX))
+        return InvalidX;
+    if (!m_Layout.isValidPlacementY(tileY, m_bNorth))
+        return InvalidY;
+
+    const float cost = iEntityStats::getStats(type).getElixirCost();
+    if (cost > m_Elixir)
+        return InsufficientElixir;
+
+    if (std::find(m_AvailableMobs.begin(), m_AvailableMobs.end(), type) == m_AvailableMobs.end())
+        return MobTypeUnavailable;
+
+    m_Elixir -= cost;
+
+    Placement p = { type, pos };
+    m_Placements.push_back(p);
+    return Success;
+}
+
+unsigned int PlayerSnapshot::queuePlacement(iEntityStats::MobType type, const Vec2& pos)
+{
+    m_PlacementResults.push_back(placeMob(type, pos));
+    return (unsigned int)(m_PlacementResults.size() - 1);
+}
@@ -0,0 +1,120 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "iPlayer.h"
+
+#include <vector>
+
+// A copy of everything a controller can see through an iPlayer, taken at one
+// moment.  It's safe to read from another thread while the game carries on,
+// since nothing in it points back into the game.
+//
+// placeMob() doesn't place anything - it does the same checks that the game 
+// will, and records the placement so that it can be sent to the game later.
+// queuePlacement() does the same, and puts its answer straight into 
+// getPlacementResults() (until the next capture).
+class PlayerSnapshot : public iPlayer
+{
+public:
+    struct Placement
+    {
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
+    PlayerSnapshot();
+    virtual ~PlayerSnapshot() {}
+
+    // Copy the state of player (which must be the real thing, on the game 
+    // thread), and clear the placements.  deltaTSec is the game time since
+    // the previous capture.
+    void capture(const iPlayer& player, unsigned int tick, float deltaTSec);
+
+    // Cheaply exchange contents with another snapshot.
+    void swap(PlayerSnapshot& rhs);
+
+    unsigned int getTick() const { return m_Tick; }
+    float getDeltaTSec() const { return m_DeltaTSec; }
+    const std::vector<Placement>& getPlacements() const { return m_Placements; }
+
+    virtual bool isNorth() const { return m_bNorth; }
+    virtual const ArenaLayout& getLayout() const { return m_Layout; }
+    virtual float getElixir() const { return m_Elixir; }
+    virtual const std::vector<iEntityStats::MobType>& GetAvailableMobTypes() const { return m_AvailableMobs; }
+    virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos);
+    virtual unsigned int queuePlacement(iEntityStats::MobType type, const Vec2& pos);
+    virtual const std::vector<PlacementResult>& getPlacementResults() const { return m_PlacementResults; }
+
+    virtual unsigned int getNumBuildings() const { return (unsigned int)m_Lists[MyBuildings].size(); }
+    virtual EntityData getBuilding(unsigned int i) const { return get(MyBuildings, i); }
+    virtual unsigned int getNumMobs() const { return (unsigned int)m_Lists[MyMobs].size(); }
+    virtual EntityData getMob(unsigned int i) const { return get(MyMobs, i); }
+
+    virtual unsigned int getNumOpponentBuildings() const { return (unsigned int)m_Lists[TheirBuildings].size(); }
+    virtual EntityData getOpponentBuilding(unsigned int i) const { return get(TheirBuildings, i); }
+    virtual unsigned int getNumOpponentMobs() const { return (unsigned int)m_Lists[TheirMobs].size(); }
+    virtual EntityData getOpponentMob(unsigned int i) const { return get(TheirMobs, i); }
+
+    virtual const InfluenceMap& getInfluence() const { return m_Influence; }
+    virtual const InfluenceMap& getOpponentInfluence() const { return m_OpponentInfluence; }
+
+private:
+    enum List
+    {
+        MyBuildings,
+        MyMobs,
+        TheirBuildings,
+        TheirMobs,
+
+        numLists
+    };
+
+    struct Entity
+    {
+        const iEntityStats* m_pStats;
+        int m_Health;
+        Vec2 m_Pos;
+    };
+
+    EntityData get(List list, unsigned int i) const;
+
+private:
+    unsigned int m_Tick;
+    float m_DeltaTSec;
+    bool m_bNorth;
+    ArenaLayout m_Layout;
+    float m_Elixir;
+
+    std::vector<iEntityStats::MobType> m_AvailableMobs;
+    std::vector<Entity> m_Lists[numLists];
+    InfluenceMap m_Influence;
+    InfluenceMap m_OpponentInfluence;
+    std::vector<Placement> m_Placements;
+    std::vector<PlacementResult> m_PlacementResults;
+
+private:
+    // DELIBERATELY UNDEFINED
+    PlayerSnapshot(const PlayerSnapshot& rhs);
+    PlayerSnapshot& operator=(const PlayerSnapshot& rhs);
+};
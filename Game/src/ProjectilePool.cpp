@@ -0,0 +1,116 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ProjectilePool.h"
+
+#include "Entity.h"
+
+#include <algorithm>
+
+ProjectilePool::ProjectilePool()
+    : m_Count(0)
+{
+    m_TimeLeft.resize(ksInitialCapacity);
+    m_FlightTime.resize(ksInitialCapacity);
+    m_StartX.resize(ksInitialCapacity);
+    m_StartY.resize(ksInitialCapacity);
+    m_pAttacker.resize(ksInitialCapacity);
+    m_pTarget.resize(ksInitialCapacity);
+    m_Damage.resize(ksInitialCapacity);
+}
+
+void ProjectilePool::grow()
+{
+    const size_t capacity = m_TimeLeft.size() * 2;
+    m_TimeLeft.resize(capacity);
+    m_FlightTime.resize(capacity);
+    m_StartX.resize(capacity);
+    m_StartY.resize(capacity);
+    m_pAttacker.resize(capacity);
+    m_pTarget.resize(capacity);
+    m_Damage.resize(capacity);
+}
+
+void ProjectilePool::launch(Entity* pAttacker, Entity* pTarget, int damage, float flightTimeSec)
+{
+    if (m_Count == m_TimeLeft.size())
+        grow();
+
+    const size_t i = m_Count++;
+    m_TimeLeft[i] = flightTimeSec;
+    m_FlightTime[i] = flightTimeSec;
+    m_StartX[i] = pAttacker->getPosition().x;
+    m_StartY[i] = pAttacker->getPosition().y;
+    m_pAttacker[i] = pAttacker;
+    m_pTarget[i] = pTarget;
+    m_Damage[i] = damage;
+}
+
+void ProjectilePool::advance(float deltaTSec, std::vector<DamageIntent>& landed)
+{
+    // Count down, and compact the ones that are still flying down to the 
+    // front as we go (which keeps them in launch order).  Nothing moves 
+    // until the first one lands, so on the (many) ticks where none do it's
+    // only the countdown.  Once one has, though, every projectile after it
+    // is copied down - and the first to land is usually the oldest.
+    float* pTimeLeft = m_TimeLeft.data();
+    size_t numFlying = 0;
+    for (size_t i = 0; i < m_Count; ++i)
+    {
+        const float timeLeft = pTimeLeft[i] - deltaTSec;
+        if (timeLeft > 0.f)
+        {
+            if (numFlying != i)
+            {
+                pTimeLeft[numFlying] = timeLeft;
+                m_FlightTime[numFlying] = m_FlightTime[i];
+                m_StartX[numFlying] = m_StartX[i];
+                m_StartY[numFlying] = m_StartY[i];
+                m_pAttacker[numFlying] = m_pAttacker[i];
+                m_pTarget[numFlying] = m_pTarget[i];
+                m_Damage[numFlying] = m_Damage[i];
+            }
+            else
+            {
+                pTimeLeft[i] = timeLeft;
+            }
+            ++numFlying;
+        }
+        else
+        {
+            DamageIntent intent = { m_pAttacker[i], m_pTarget[i], m_Damage[i] };
+            landed.push_back(intent);
+        }
+    }
+    m_Count = numFlying;
+}
+
+Vec2 ProjectilePool::getPosition(size_t i) const
+{
+    const Vec2 start(m_StartX[i], m_StartY[i]);
+    const Vec2& end = m_pTarget[i]->getPosition();
+    if (m_FlightTime[i] <= 0.f)
+        return end;
+
+    const float t = 1.f - std::max(m_TimeLeft[i], 0.f) / m_FlightTime[i];
+    return start + (end - start) * Real(t);
+}
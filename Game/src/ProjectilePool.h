@@ -0,0 +1,83 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "IntentBuffer.h"
+#include "Vec2.h"
+
+#include <stddef.h>
+#include <vector>
+
+class Entity;
+
+// Every ranged attack that's in the air.  Rather than an object for each 
+// projectile, they're kept as parallel arrays (allocated up front, and only
+// grown if a fight gets bigger than any before it), so that advancing all 
+// of them is one short loop over a few arrays - even with hundreds of 
+// archers firing at once.
+//
+// A projectile homes in on its target, and lands flightTimeSec after it was
+// launched.  Entities are never deleted while the Game is running (see 
+// Player::removeDeadMobs()), so the target pointer is a safe handle even if
+// it has died in the meantime.
+class ProjectilePool
+{
+public:
+    static const size_t ksInitialCapacity = 1024;
+
+    ProjectilePool();
+
+    void launch(Entity* pAttacker, Entity* pTarget, int damage, float flightTimeSec);
+
+    // Move every projectile along by deltaTSec.  The ones that land are 
+    // appended to landed, in the order that they were launched, and taken
+    // out of the pool.
+    void advance(float deltaTSec, std::vector<DamageIntent>& landed);
+
+    size_t getNumProjectiles() const { return m_Count; }
+    size_t getCapacity() const { return m_TimeLeft.size(); }
+
+    // For drawing: where projectile i is now, between where it was launched
+    // from and where its target is.
+    Vec2 getPosition(size_t i) const;
+
+private:
+    void grow();
+
+private:
+    size_t m_Count;
+
+    // Only m_TimeLeft is touched for projectiles that are still flying.
+    std::vector<float> m_TimeLeft;
+    std::vector<float> m_FlightTime;
+    std::vector<Real> m_StartX;
+    std::vector<Real> m_StartY;
+    std::vector<Entity*> m_pAttacker;
+    std::vector<Entity*> m_pTarget;
+    std::vector<int> m_Damage;
+
+private:
+    // DELIBERATELY UNDEFINED
+    ProjectilePool(const ProjectilePool& rhs);
+    ProjectilePool& operator=(const ProjectilePool& rhs);
+};
@@ -0,0 +1,257 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Scenario.h"
+
+#include "Entity.h"
+#include "Game.h"
+#include "iController.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <ctype.h>
+
+// Places one side's mobs when the scenario says to.
+class Controller_Scenario : public iController
+{
+public:
+    Controller_Scenario(const std::vector<Scenario::Spawn>& spawns)
+        : m_Spawns(spawns)
+        , m_Time(0.f)
+        , m_Next(0)
+    {}
+
+    virtual void tick(float deltaTSec)
+    {
+        m_Time += deltaTSec;
+
+        // Allow for rounding in the sum, so that (for example) a spawn at 
+        // 1.0 seconds happens on the 20th tick, not the 21st.
+        while ((m_Next < m_Spawns.size()) && (m_Spawns[m_Next].m_Time <= m_Time + ksTimeEpsilon))
+        {
+            const Scenario::Spawn& spawn = m_Spawns[m_Next++];
+            m_pPlayer->placeMob(spawn.m_Type, spawn.m_Pos);
+        }
+    }
+
+private:
+    static const float ksTimeEpsilon;
+
+    std::vector<Scenario::Spawn> m_Spawns;      // just this side's
+    float m_Time;
+    size_t m_Next;
+};
+
+const float Controller_Scenario::ksTimeEpsilon = 0.001f;
+
+Scenario::Scenario()
+    : m_Duration(180.f)
+    , m_ExpectedWinner(Unspecified)
+{
+    m_Elixir[0] = m_Elixir[1] = -1.f;
+}
+
+bool Scenario::load(const std::string& path)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+    {
+        std::cerr << path << ": can't open the file\n";
+        return false;
+    }
+
+    // Name it after the file, unless it says otherwise.
+    const size_t slash = path.find_last_of("/\\");
+    m_Name = path.substr((slash == std::string::npos) ? 0 : slash + 1);
+    m_Name = m_Name.substr(0, m_Name.find_last_of('.'));
+
+    return parse(in, path);
+}
+
+static bool equalsIgnoreCase(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b))
+            return false;
+    }
+    return *a == *b;
+}
+
+static bool parseSide(const std::string& word, bool& bNorth)
+{
+    if (equalsIgnoreCase(word.c_str(), "north")) { bNorth = true; return true; }
+    if (equalsIgnoreCase(word.c_str(), "south")) { bNorth = false; return true; }
+    return false;
+}
+
+bool Scenario::parse(std::istream& in, const std::string& sourceName)
+{
+    std::string line;
+    for (int lineNum = 1; std::getline(in, line); ++lineNum)
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command))
+            continue;
+
+        bool bOk = true;
+        std::string side;
+        bool bNorth = true;
+        if (command == "name")
+        {
+            std::getline(words >> std::ws, m_Name);
+            m_Name = m_Name.substr(0, m_Name.find_last_not_of(" \t\r") + 1);
+            bOk = !m_Name.empty();
+        }
+        else if (command == "arena")
+        {
+            // Spawns are checked against the arena as they're read.
+            int width, height;
+            bOk = (words >> width >> height) && (width > 0) && (height > 0) && (width % 2 == 0) && m_Spawns.empty();
+            if (bOk)
+                m_Layout = ArenaLayout(width, height);
+        }
+        else if (command == "duration")
+        {
+            bOk = (words >> m_Duration) && (m_Duration > 0.f);
+        }
+        else if (command == "elixir")
+        {
+            float elixir;
+            bOk = (words >> side >> elixir) && parseSide(side, bNorth) && (elixir >= 0.f);
+            if (bOk)
+                m_Elixir[bNorth ? 0 : 1] = elixir;
+        }
+        else if (command == "tower")
+        {
+            std::string which;
+            TowerHealth tower;
+            bOk = (words >> side >> which >> tower.m_Health) && parseSide(side, bNorth) && (tower.m_Health > 0);
+            tower.m_bNorth = bNorth;
+
+            // The same order as Player::buildBuildings().
+            if (which == "king") tower.m_Index = 0;
+            else if (which == "left") tower.m_Index = 1;
+            else if (which == "right") tower.m_Index = 2;
+            else bOk = false;
+
+            if (bOk)
+                m_Towers.push_back(tower);
+        }
+        else if (command == "expect")
+        {
+            std::string who;
+            bOk = !!(words >> who);
+            if (who == "north") m_ExpectedWinner = North;
+            else if (who == "south") m_ExpectedWinner = South;
+            else if (who == "none") m_ExpectedWinner = NoWinner;
+            else bOk = false;
+        }
+        else if (command == "at")
+        {
+            Spawn spawn;
+            std::string typeName;
+            float x, y;
+            bOk = (words >> spawn.m_Time >> side >> typeName >> x >> y) && parseSide(side, bNorth) && (spawn.m_Time >= 0.f);
+            spawn.m_bNorth = bNorth;
+            spawn.m_Pos = Vec2(x, y);
+
+            size_t type = 0;
+            for (; type < iEntityStats::numMobTypes; ++type)
+            {
+                if (equalsIgnoreCase(typeName.c_str(), iEntityStats::getStats((iEntityStats::MobType)type).getName()))
+                    break;
+            }
+            spawn.m_Type = (iEntityStats::MobType)type;
+
+            if (bOk && (type == iEntityStats::numMobTypes))
+            {
+                std::cerr << sourceName << ":" << lineNum << ": unknown mob type '" << typeName << "'\n";
+                return false;
+            }
+
+            // The same checks as Player::placeMob(), so that a typo doesn't 
+            // quietly change the battle.
+            const float tileY = (float)(int)y + 0.5f;
+            const bool bOnOurSide = m_Layout.isValidPlacementY(Real(tileY), bNorth);
+            if (bOk && ((x < 0.f) || (x >= (float)m_Layout.getWidth()) || !bOnOurSide))
+            {
+                std::cerr << sourceName << ":" << lineNum << ": (" << x << ", " << y << ") isn't on " << side << "'s side of the arena\n";
+                return false;
+            }
+
+            if (bOk)
+                m_Spawns.push_back(spawn);
+        }
+        else
+        {
+            std::cerr << sourceName << ":" << lineNum << ": unknown command '" << command << "'\n";
+            return false;
+        }
+
+        std::string extra;
+        if (!bOk || (words >> extra))
+        {
+            std::cerr << sourceName << ":" << lineNum << ": can't read '" << line << "'\n";
+            return false;
+        }
+    }
+
+    std::stable_sort(m_Spawns.begin(), m_Spawns.end(),
+        [](const Spawn& a, const Spawn& b) { return a.m_Time < b.m_Time; });
+    return true;
+}
+
+Game* Scenario::createGame(unsigned int numThreads) const
+{
+    std::vector<Spawn> spawns[2];
+    for (const Spawn& spawn : m_Spawns)
+    {
+        spawns[spawn.m_bNorth ? 0 : 1].push_back(spawn);
+    }
+
+    Game* pGame = new Game(new Controller_Scenario(spawns[0]), new Controller_Scenario(spawns[1]), numThreads, m_Layout);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (m_Elixir[i] >= 0.f)
+            pGame->getPlayer(i == 0).setElixir(m_Elixir[i]);
+    }
+
+    for (const TowerHealth& tower : m_Towers)
+    {
+        pGame->getPlayer(tower.m_bNorth).getBuildings()[tower.m_Index]->setHealth(tower.m_Health);
+    }
+
+    return pGame;
+}
+
+Scenario::Winner Scenario::getWinner(Game& game)
+{
+    const int state = game.checkGameOver();
+    return (state > 0) ? North : (state < 0) ? South : NoWinner;
+}
@@ -0,0 +1,107 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "EntityStats.h"
+#include "Vec2.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+class Game;
+
+// A scripted battle: how much elixir each side starts with, any towers that
+// start out damaged, and which mobs each side places where and when.  The 
+// same scenario always plays out the same way, so they make good benchmarks
+// and regression tests.
+//
+// Scenarios are text files, one command per line, with # starting a 
+// comment.  Times are in seconds of game time, and positions in tiles.
+//
+//     name <name>                      (defaults to the file name)
+//     arena <width> <height>           (in tiles, default 18 32; before any spawns)
+//     duration <seconds>               (stop here if nobody has won, default 180)
+//     elixir <north|south> <amount>
+//     tower <north|south> <king|left|right> <health>
+//     expect <north|south|none>        (who should win, for regression tests)
+//     at <seconds> <north|south> <mob type> <x> <y>
+//
+// Spawns go through Player::placeMob(), so they follow all of the usual 
+// rules (including elixir).  Spawns that would be in the wrong place are 
+// caught when the scenario is loaded.
+class Scenario
+{
+public:
+    enum Winner
+    {
+        NoWinner = 0,
+        North,
+        South,
+        Unspecified,            // no "expect" line
+    };
+
+    struct Spawn
+    {
+        float m_Time;
+        bool m_bNorth;
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
+    Scenario();
+
+    // Prints what's wrong to std::cerr, and returns false, if the file 
+    // can't be read.
+    bool load(const std::string& path);
+    bool parse(std::istream& in, const std::string& sourceName);
+
+    // Sets up a match (at time 0) from this scenario.  The caller owns it.
+    Game* createGame(unsigned int numThreads = 0) const;
+
+    // Who won, if the match is over (see Game::checkGameOver()).
+    static Winner getWinner(Game& game);
+
+    const std::string& getName() const { return m_Name; }
+    float getDuration() const { return m_Duration; }
+    const ArenaLayout& getLayout() const { return m_Layout; }
+    Winner getExpectedWinner() const { return m_ExpectedWinner; }
+    const std::vector<Spawn>& getSpawns() const { return m_Spawns; }
+
+private:
+    struct TowerHealth
+    {
+        bool m_bNorth;
+        unsigned int m_Index;           // into Player::getBuildings()
+        int m_Health;
+    };
+
+    std::string m_Name;
+    ArenaLayout m_Layout;
+    float m_Duration;
+    float m_Elixir[2];                  // north, south.  Negative => the default
+    Winner m_ExpectedWinner;
+    std::vector<TowerHealth> m_Towers;
+    std::vector<Spawn> m_Spawns;        // sorted by time
+};
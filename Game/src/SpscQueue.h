@@ -0,0 +1,82 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+// A bounded, lock-free queue for exactly one producer thread and one 
+// consumer thread.  The capacity is rounded up to a power of two.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_Head(0)
+        , m_Tail(0)
+    {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_Items.resize(size);
+        m_Mask = size - 1;
+    }
+
+    // Producer only.  Returns false (and drops item) if the queue is full.
+    bool push(const T& item)
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head - m_Tail.load(std::memory_order_acquire) > m_Mask)
+            return false;
+
+        m_Items[head & m_Mask] = item;
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.  Returns false if the queue is empty.
+    bool pop(T& item)
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail == m_Head.load(std::memory_order_acquire))
+            return false;
+
+        item = m_Items[tail & m_Mask];
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_Items;
+    size_t m_Mask;
+
+    // On separate cache lines, so the two threads don't fight over them.
+    alignas(64) std::atomic<size_t> m_Head;     // written by the producer
+    alignas(64) std::atomic<size_t> m_Tail;     // written by the consumer
+
+private:
+    // DELIBERATELY UNDEFINED
+    SpscQueue(const SpscQueue& rhs);
+    SpscQueue& operator=(const SpscQueue& rhs);
+};
@@ -0,0 +1,527 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "StateStream.h"
+
+#include "Entity.h"
+#include "Game.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+// Varints are 7 bits per byte, low bits first, with the top bit set on 
+// every byte but the last.  Signed values are zigzagged first (0, -1, 1, 
+// -2, 2... => 0, 1, 2, 3, 4...) so that small negative numbers stay small.
+static void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void writeSigned(std::vector<uint8_t>& out, int64_t value)
+{
+    writeVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+// Hashes are random looking, so they'd only get bigger as varints.
+static void writeFixed64(std::vector<uint8_t>& out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+namespace
+{
+    // Reads varints out of a buffer.  Running off the end (or a varint 
+    // that's too long) clears m_bOk, and everything after that reads as 0.
+    class ByteReader
+    {
+    public:
+        ByteReader(const uint8_t* pBegin, const uint8_t* pEnd)
+            : m_pCurr(pBegin), m_pEnd(pEnd), m_bOk(true) {}
+
+        uint64_t readVarint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (m_pCurr == m_pEnd)
+                    break;
+                const uint8_t byte = *m_pCurr++;
+                value |= (uint64_t)(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            m_bOk = false;
+            return 0;
+        }
+
+        int64_t readSigned()
+        {
+            const uint64_t value = readVarint();
+            return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+        }
+
+        uint64_t readFixed(int numBytes)
+        {
+            if (getRemaining() < (size_t)numBytes)
+            {
+                m_bOk = false;
+                m_pCurr = m_pEnd;
+                return 0;
+            }
+
+            uint64_t value = 0;
+            for (int i = 0; i < numBytes; ++i)
+                value |= (uint64_t)*m_pCurr++ << (8 * i);
+            return value;
+        }
+
+        // Skip over size bytes, e.g. a payload we don't need yet.
+        void skip(uint64_t size)
+        {
+            if (size > getRemaining())
+                m_bOk = false, size = getRemaining();
+            m_pCurr += size;
+        }
+
+        // Every entry in a list takes at least a byte, so this is a cheap 
+        // sanity check on a count before we reserve room for it.
+        size_t getRemaining() const { return m_pEnd - m_pCurr; }
+        const uint8_t* getCurrent() const { return m_pCurr; }
+        bool isOk() const { return m_bOk; }
+
+    private:
+        const uint8_t* m_pCurr;
+        const uint8_t* m_pEnd;
+        bool m_bOk;
+    };
+}
+
+// Spawns, and everything in a keyframe, are written in full.  Ids are 
+// ascending, so we write the gap from the one before.
+static void writeEntity(std::vector<uint8_t>& out, const StreamEntity& entity, uint32_t prevId)
+{
+    writeVarint(out, entity.m_Id - prevId);
+    writeVarint(out, (entity.m_bNorth ? 1 : 0) | (entity.m_bBuilding ? 2 : 0));
+    writeVarint(out, entity.m_Type);
+    writeSigned(out, entity.m_X);
+    writeSigned(out, entity.m_Y);
+    writeSigned(out, entity.m_Health);
+}
+
+static StreamEntity readEntity(ByteReader& in, uint32_t prevId)
+{
+    StreamEntity entity;
+    entity.m_Id = prevId + (uint32_t)in.readVarint();
+    const uint64_t flags = in.readVarint();
+    entity.m_bNorth = (flags & 1) != 0;
+    entity.m_bBuilding = (flags & 2) != 0;
+    entity.m_Type = (uint8_t)in.readVarint();
+    entity.m_X = (int32_t)in.readSigned();
+    entity.m_Y = (int32_t)in.readSigned();
+    entity.m_Health = (int32_t)in.readSigned();
+    return entity;
+}
+
+static bool lessById(const StreamEntity& a, const StreamEntity& b)
+{
+    return a.m_Id < b.m_Id;
+}
+
+// Which fields a change carries.
+static const uint64_t ksChangedX = 1;
+static const uint64_t ksChangedY = 2;
+static const uint64_t ksChangedHealth = 4;
+
+static uint32_t toMilliseconds(float sec)
+{
+    return (uint32_t)std::lround(sec * 1000.f);
+}
+
+StateStreamWriter::StateStreamWriter(std::ostream& out, const ArenaLayout& layout, float keyframeIntervalSec,
+                                     bool bRecordHashes)
+    : m_Out(out)
+    , m_KeyframeIntervalSec(keyframeIntervalSec)
+    , m_bRecordHashes(bRecordHashes)
+    , m_NextKeyframeSec(0.f)
+    , m_NumFrames(0)
+    , m_NumBytes(0)
+    , m_KeyframeBytes(0)
+{
+    std::vector<uint8_t> header;
+    for (int i = 0; i < 4; ++i)
+        header.push_back((uint8_t)(ksMagic >> (8 * i)));
+    writeVarint(header, ksVersion);
+    writeVarint(header, bRecordHashes ? ksHasHashes : 0);
+    writeVarint(header, layout.getWidth());
+    writeVarint(header, layout.getHeight());
+
+    m_Out.write((const char*)header.data(), header.size());
+    m_NumBytes += header.size();
+}
+
+void StateStreamWriter::gather(Game& game)
+{
+    m_Curr.clear();
+    for (bool bNorth : { true, false })
+    {
+        const Player& player = game.getPlayer(bNorth);
+        for (bool bBuilding : { true, false })
+        {
+            for (const Entity* pEntity : bBuilding ? player.getBuildings() : player.getMobs())
+            {
+                if (pEntity->isDead())
+                    continue;
+
+                const iEntityStats& stats = pEntity->getStats();
+                StreamEntity entity;
+                entity.m_Id = pEntity->getId();
+                entity.m_bNorth = bNorth;
+                entity.m_bBuilding = bBuilding;
+                entity.m_Type = (uint8_t)(bBuilding ? (int)stats.getBuildingType() : (int)stats.getMobType());
+                entity.m_X = (int32_t)std::lround((float)pEntity->getPosition().x * 100.f);
+                entity.m_Y = (int32_t)std::lround((float)pEntity->getPosition().y * 100.f);
+                entity.m_Health = pEntity->getHealth();
+                m_Curr.push_back(entity);
+            }
+        }
+    }
+    std::sort(m_Curr.begin(), m_Curr.end(), lessById);
+}
+
+void StateStreamWriter::record(Game& game)
+{
+    gather(game);
+
+    m_Payload.clear();
+    writeVarint(m_Payload, m_NumFrames);
+    writeVarint(m_Payload, toMilliseconds(game.getTime()));
+    if (m_bRecordHashes)
+        writeFixed64(m_Payload, game.getStateHash());
+
+    if ((m_NumFrames == 0) || (game.getTime() >= m_NextKeyframeSec))
+    {
+        m_NextKeyframeSec = game.getTime() + m_KeyframeIntervalSec;
+
+        writeVarint(m_Payload, m_Curr.size());
+        uint32_t prevId = 0;
+        for (const StreamEntity& entity : m_Curr)
+        {
+            writeEntity(m_Payload, entity, prevId);
+            prevId = entity.m_Id;
+        }
+        writeRecord(Keyframe);
+    }
+    else
+    {
+        // Both lists are sorted by id, so walk them together.  Anything 
+        // only in m_Prev died, anything only in m_Curr spawned.
+        std::vector<uint8_t>& deaths = m_Sections[0];
+        std::vector<uint8_t>& spawns = m_Sections[1];
+        std::vector<uint8_t>& changes = m_Sections[2];
+        deaths.clear();
+        spawns.clear();
+        changes.clear();
+        size_t numDeaths = 0, numSpawns = 0, numChanges = 0;
+        uint32_t prevDeath = 0, prevSpawn = 0, prevChange = 0;
+
+        size_t p = 0, c = 0;
+        while ((p < m_Prev.size()) || (c < m_Curr.size()))
+        {
+            if ((c == m_Curr.size()) || ((p < m_Prev.size()) && (m_Prev[p].m_Id < m_Curr[c].m_Id)))
+            {
+                writeVarint(deaths, m_Prev[p].m_Id - prevDeath);
+                prevDeath = m_Prev[p++].m_Id;
+                ++numDeaths;
+            }
+            else if ((p == m_Prev.size()) || (m_Curr[c].m_Id < m_Prev[p].m_Id))
+            {
+                writeEntity(spawns, m_Curr[c], prevSpawn);
+                prevSpawn = m_Curr[c++].m_Id;
+                ++numSpawns;
+            }
+            else
+            {
+                const StreamEntity& prev = m_Prev[p++];
+                const StreamEntity& curr = m_Curr[c++];
+                const uint64_t mask = ((curr.m_X != prev.m_X) ? ksChangedX : 0) |
+                                      ((curr.m_Y != prev.m_Y) ? ksChangedY : 0) |
+                                      ((curr.m_Health != prev.m_Health) ? ksChangedHealth : 0);
+                if (!mask)
+                    continue;
+
+                writeVarint(changes, curr.m_Id - prevChange);
+                writeVarint(changes, mask);
+                if (mask & ksChangedX) writeSigned(changes, curr.m_X - prev.m_X);
+                if (mask & ksChangedY) writeSigned(changes, curr.m_Y - prev.m_Y);
+                if (mask & ksChangedHealth) writeSigned(changes, curr.m_Health - prev.m_Health);
+                prevChange = curr.m_Id;
+                ++numChanges;
+            }
+        }
+
+        writeVarint(m_Payload, numDeaths);
+        m_Payload.insert(m_Payload.end(), deaths.begin(), deaths.end());
+        writeVarint(m_Payload, numSpawns);
+        m_Payload.insert(m_Payload.end(), spawns.begin(), spawns.end());
+        writeVarint(m_Payload, numChanges);
+        m_Payload.insert(m_Payload.end(), changes.begin(), changes.end());
+        writeRecord(Delta);
+    }
+
+    m_Prev.swap(m_Curr);
+    ++m_NumFrames;
+}
+
+void StateStreamWriter::writeRecord(RecordKind kind)
+{
+    std::vector<uint8_t>& prefix = m_Sections[0];
+    prefix.clear();
+    prefix.push_back((uint8_t)kind);
+    writeVarint(prefix, m_Payload.size());
+
+    m_Out.write((const char*)prefix.data(), prefix.size());
+    m_Out.write((const char*)m_Payload.data(), m_Payload.size());
+
+    const uint64_t numBytes = prefix.size() + m_Payload.size();
+    m_NumBytes += numBytes;
+    if (kind == Keyframe)
+        m_KeyframeBytes += numBytes;
+}
+
+StateStreamReader::StateStreamReader()
+    : m_bHasHashes(false)
+    , m_Frame(0)
+    , m_TimeMs(0)
+{
+}
+
+bool StateStreamReader::load(const std::string& path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in)
+    {
+        std::cerr << path << ": can't open the file\n";
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse(data, path);
+}
+
+bool StateStreamReader::fail(const char* pWhat)
+{
+    std::cerr << m_SourceName << ": " << pWhat << "\n";
+    m_Records.clear();
+    m_Entities.clear();
+    return false;
+}
+
+bool StateStreamReader::parse(const std::vector<uint8_t>& data, const std::string& sourceName)
+{
+    m_SourceName = sourceName;
+    m_Data = data;
+    m_Records.clear();
+    m_Entities.clear();
+
+    const uint8_t* pBegin = m_Data.data();
+    ByteReader in(pBegin, pBegin + m_Data.size());
+
+    if (in.readFixed(4) != StateStreamWriter::ksMagic)
+        return fail("not a state stream");
+    if (in.readVarint() != StateStreamWriter::ksVersion)
+        return fail("unsupported version");
+    m_bHasHashes = (in.readVarint() & StateStreamWriter::ksHasHashes) != 0;
+
+    const int width = (int)in.readVarint();
+    const int height = (int)in.readVarint();
+    if (!in.isOk() || (width <= 0) || (height <= 0))
+        return fail("bad header");
+    m_Layout = ArenaLayout(width, height);
+
+    // Index the records, so that we can seek without decoding them all.
+    unsigned int keyframe = 0;
+    while (in.getRemaining() > 0)
+    {
+        RecordInfo record;
+        const uint64_t kind = in.readVarint();
+        record.m_Size = (size_t)in.readVarint();
+        record.m_Offset = in.getCurrent() - pBegin;
+        record.m_bKeyframe = (kind == StateStreamWriter::Keyframe);
+        in.skip(record.m_Size);
+        if (!in.isOk() || (kind > StateStreamWriter::Delta))
+            return fail("bad record");
+
+        if (record.m_bKeyframe)
+            keyframe = (unsigned int)m_Records.size();
+        else if (m_Records.empty())
+            return fail("doesn't start with a keyframe");
+        record.m_Keyframe = keyframe;
+        m_Records.push_back(record);
+    }
+
+    if (m_Records.empty())
+        return fail("no frames");
+    return apply(0);
+}
+
+bool StateStreamReader::getStateHash(unsigned int frame, uint64_t& hash) const
+{
+    if (!m_bHasHashes || (frame >= m_Records.size()))
+        return false;
+
+    const RecordInfo& record = m_Records[frame];
+    const uint8_t* pPayload = m_Data.data() + record.m_Offset;
+    ByteReader in(pPayload, pPayload + record.m_Size);
+    in.readVarint();
+    in.readVarint();
+    hash = in.readFixed(8);
+    return in.isOk();
+}
+
+bool StateStreamReader::seek(unsigned int frame)
+{
+    if (frame >= m_Records.size())
+        return false;
+
+    // Carry on from where we are if that's closer than the keyframe.
+    unsigned int start = m_Records[frame].m_Keyframe;
+    if ((m_Frame >= start) && (m_Frame <= frame))
+        start = m_Frame + 1;
+    if (frame == m_Frame)
+        return true;
+
+    for (unsigned int i = start; i <= frame; ++i)
+    {
+        if (!apply(i))
+            return false;
+    }
+    return true;
+}
+
+bool StateStreamReader::next()
+{
+    return seek(m_Frame + 1);
+}
+
+bool StateStreamReader::apply(unsigned int frame)
+{
+    const RecordInfo& record = m_Records[frame];
+    const uint8_t* pPayload = m_Data.data() + record.m_Offset;
+    ByteReader in(pPayload, pPayload + record.m_Size);
+
+    if (in.readVarint() != frame)
+        return fail("frames out of order");
+    m_TimeMs = (uint32_t)in.readVarint();
+    if (m_bHasHashes)
+        in.readFixed(8);
+
+    if (record.m_bKeyframe)
+    {
+        const uint64_t count = in.readVarint();
+        if (count > in.getRemaining())
+            return fail("bad keyframe");
+
+        m_Entities.clear();
+        uint32_t prevId = 0;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            m_Entities.push_back(readEntity(in, prevId));
+            prevId = m_Entities.back().m_Id;
+        }
+    }
+    else
+    {
+        const uint64_t numDeaths = in.readVarint();
+        if (numDeaths > in.getRemaining())
+            return fail("bad delta");
+        m_Deaths.clear();
+        uint32_t prevId = 0;
+        for (uint64_t i = 0; i < numDeaths; ++i)
+        {
+            prevId += (uint32_t)in.readVarint();
+            m_Deaths.push_back(prevId);
+        }
+
+        const uint64_t numSpawns = in.readVarint();
+        if (numSpawns > in.getRemaining())
+            return fail("bad delta");
+        m_Spawns.clear();
+        prevId = 0;
+        for (uint64_t i = 0; i < numSpawns; ++i)
+        {
+            m_Spawns.push_back(readEntity(in, prevId));
+            prevId = m_Spawns.back().m_Id;
+        }
+
+        // Take out the dead, and merge in the spawns.  Everything is sorted
+        // by id.
+        m_Scratch.clear();
+        size_t d = 0, s = 0;
+        for (const StreamEntity& entity : m_Entities)
+        {
+            while ((s < m_Spawns.size()) && (m_Spawns[s].m_Id < entity.m_Id))
+                m_Scratch.push_back(m_Spawns[s++]);
+            if ((d < m_Deaths.size()) && (m_Deaths[d] == entity.m_Id))
+                ++d;
+            else
+                m_Scratch.push_back(entity);
+        }
+        m_Scratch.insert(m_Scratch.end(), m_Spawns.begin() + s, m_Spawns.end());
+        m_Entities.swap(m_Scratch);
+        if (d != m_Deaths.size())
+            return fail("an entity died that didn't exist");
+
+        const uint64_t numChanges = in.readVarint();
+        size_t e = 0;
+        prevId = 0;
+        for (uint64_t i = 0; (i < numChanges) && in.isOk(); ++i)
+        {
+            prevId += (uint32_t)in.readVarint();
+            while ((e < m_Entities.size()) && (m_Entities[e].m_Id < prevId))
+                ++e;
+            if ((e == m_Entities.size()) || (m_Entities[e].m_Id != prevId))
+                return fail("an entity changed that didn't exist");
+
+            StreamEntity& entity = m_Entities[e];
+            const uint64_t mask = in.readVarint();
+            if (mask & ksChangedX) entity.m_X += (int32_t)in.readSigned();
+            if (mask & ksChangedY) entity.m_Y += (int32_t)in.readSigned();
+            if (mask & ksChangedHealth) entity.m_Health += (int32_t)in.readSigned();
+        }
+    }
+
+    if (!in.isOk() || (in.getRemaining() > 0))
+        return fail("bad record");
+
+    m_Frame = frame;
+    return true;
+}
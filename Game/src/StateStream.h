@@ -0,0 +1,193 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ArenaLayout.h"
+#include "Vec2.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Game;
+
+// A recording of a match that can be played back (and jumped around in) 
+// without running the simulation - for spectating, or scrubbing through a
+// match after the fact.
+//
+// Every few seconds we write a keyframe, which is the whole state, and 
+// every tick in between we write a delta, which is just what changed since
+// the tick before: the entities that died, the ones that spawned, and the
+// positions and health that moved.  Positions are rounded to centimeters,
+// and everything is written as varints (zigzagged if it can be negative),
+// so a quiet tick costs a few bytes.  To get to any tick the reader only 
+// has to decode the keyframe before it and the deltas since.
+//
+// Each tick can also carry Game::getStateHash(), so that two recordings of
+// the same match can be checked against each other tick by tick.
+//
+// The file is a header, then one record per tick:
+//     header:  "CLSS", version, flags, arena width, arena height
+//     record:  kind (keyframe or delta), payload size, payload
+//     keyframe payload:  frame, time (ms), [hash], entity count, entities
+//     delta payload:     frame, time (ms), [hash], deaths, spawns, changes
+// The hash is 8 bytes, and only there if the flags say so.  All of the 
+// other numbers are varints.  See StateStream.cpp for the details.
+
+// One entity, as the stream sees it.
+struct StreamEntity
+{
+    uint32_t m_Id;
+    bool m_bNorth;
+    bool m_bBuilding;
+    uint8_t m_Type;         // an iEntityStats::MobType, or BuildingType for buildings
+    int32_t m_X;            // in centimeters
+    int32_t m_Y;
+    int32_t m_Health;
+
+    Vec2 getPosition() const { return Vec2(m_X / 100.f, m_Y / 100.f); }
+
+    bool operator==(const StreamEntity& rhs) const
+    {
+        return (m_Id == rhs.m_Id) && (m_bNorth == rhs.m_bNorth) && (m_bBuilding == rhs.m_bBuilding) &&
+               (m_Type == rhs.m_Type) && (m_X == rhs.m_X) && (m_Y == rhs.m_Y) && (m_Health == rhs.m_Health);
+    }
+};
+
+class StateStreamWriter
+{
+public:
+    static const uint32_t ksMagic = 0x53534C43;        // "CLSS"
+    static const uint32_t ksVersion = 2;
+
+    // Flags, in the header.
+    static const uint32_t ksHasHashes = 1;
+
+    enum RecordKind
+    {
+        Keyframe = 0,
+        Delta = 1,
+    };
+
+    // We don't own out.  It should be opened in binary mode.
+    StateStreamWriter(std::ostream& out, const ArenaLayout& layout, float keyframeIntervalSec = 5.f,
+                      bool bRecordHashes = true);
+
+    // Call once after each Game::tick(), starting with the first.
+    void record(Game& game);
+
+    // What the last record() saw, sorted by id.
+    const std::vector<StreamEntity>& getEntities() const { return m_Prev; }
+
+    unsigned int getNumFrames() const { return m_NumFrames; }
+    uint64_t getNumBytes() const { return m_NumBytes; }
+    uint64_t getKeyframeBytes() const { return m_KeyframeBytes; }
+
+private:
+    void gather(Game& game);
+    void writeRecord(RecordKind kind);
+
+private:
+    std::ostream& m_Out;
+    float m_KeyframeIntervalSec;
+    bool m_bRecordHashes;
+    float m_NextKeyframeSec;
+    unsigned int m_NumFrames;
+    uint64_t m_NumBytes;
+    uint64_t m_KeyframeBytes;
+
+    std::vector<StreamEntity> m_Prev;       // sorted by id
+    std::vector<StreamEntity> m_Curr;
+    std::vector<uint8_t> m_Payload;         // scratch
+    std::vector<uint8_t> m_Sections[3];
+
+private:
+    // DELIBERATELY UNDEFINED
+    StateStreamWriter(const StateStreamWriter& rhs);
+    StateStreamWriter& operator=(const StateStreamWriter& rhs);
+};
+
+class StateStreamReader
+{
+public:
+    StateStreamReader();
+
+    // Prints what's wrong to std::cerr, and returns false, if the stream 
+    // can't be read.  On success we're at frame 0.
+    bool load(const std::string& path);
+    bool parse(const std::vector<uint8_t>& data, const std::string& sourceName);
+
+    const ArenaLayout& getLayout() const { return m_Layout; }
+    unsigned int getNumFrames() const { return (unsigned int)m_Records.size(); }
+
+    // Jump to any frame, by way of the keyframe before it.
+    bool seek(unsigned int frame);
+
+    // Move on to the next frame.  Returns false at the end.
+    bool next();
+
+    unsigned int getFrame() const { return m_Frame; }
+    float getTime() const { return m_TimeMs / 1000.f; }
+
+    // The Game's state hash at any frame, without having to seek there.  
+    // Returns false if the stream doesn't have hashes.
+    bool hasHashes() const { return m_bHasHashes; }
+    bool getStateHash(unsigned int frame, uint64_t& hash) const;
+
+    // Everything that's alive at the current frame, sorted by id.
+    const std::vector<StreamEntity>& getEntities() const { return m_Entities; }
+
+private:
+    // Decode the record for frame on top of m_Entities, which has to be at 
+    // the frame before (unless it's a keyframe).
+    bool apply(unsigned int frame);
+    bool fail(const char* pWhat);
+
+private:
+    struct RecordInfo
+    {
+        size_t m_Offset;            // of the payload
+        size_t m_Size;
+        unsigned int m_Keyframe;    // the record to start from to get here
+        bool m_bKeyframe;
+    };
+
+    std::string m_SourceName;
+    std::vector<uint8_t> m_Data;
+    std::vector<RecordInfo> m_Records;
+    ArenaLayout m_Layout;
+    bool m_bHasHashes;
+
+    unsigned int m_Frame;
+    uint32_t m_TimeMs;
+    std::vector<StreamEntity> m_Entities;
+    std::vector<StreamEntity> m_Scratch;
+    std::vector<StreamEntity> m_Spawns;
+    std::vector<uint32_t> m_Deaths;
+
+private:
+    // DELIBERATELY UNDEFINED
+    StateStreamReader(const StateStreamReader& rhs);
+    StateStreamReader& operator=(const StateStreamReader& rhs);
+};
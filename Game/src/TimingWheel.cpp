@@ -0,0 +1,149 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+TimingWheel::TimingWheel(float slotDurationSec)
+    : m_SlotDuration(slotDurationSec)
+    , m_CurSlot(0)
+    , m_NumPending(0)
+{
+    assert(m_SlotDuration > 0.f);
+}
+
+void TimingWheel::schedule(float dueTime, iTimedEvent* pEvent)
+{
+    assert(!!pEvent);
+
+    Entry e = { dueTime, pEvent };
+    insert(e);
+    ++m_NumPending;
+}
+
+void TimingWheel::advance(float now)
+{
+    const unsigned long long targetSlot = slotOf(now);
+
+    while (true)
+    {
+        // Pull out everything in this slot that is due.  Only the last slot
+        // can hold events that aren't due yet - they stay where they are.
+        Bucket& bucket = m_Level0[m_CurSlot & kSlotMask];
+        size_t keep = 0;
+        for (size_t i = 0; i < bucket.size(); ++i)
+        {
+            if (bucket[i].m_DueTime < now)
+            {
+                m_Due.push_back(bucket[i]);
+            }
+            else
+            {
+                assert(m_CurSlot == targetSlot);
+                bucket[keep++] = bucket[i];
+            }
+        }
+        bucket.resize(keep);
+
+        if (m_CurSlot >= targetSlot)
+            break;
+
+        ++m_CurSlot;
+        if ((m_CurSlot & kSlotMask) == 0)
+        {
+            cascade();
+        }
+    }
+
+    if (m_Due.empty())
+        return;
+
+    // Fire in due time order.  Use a stable sort so that ties fire in the 
+    // order that they were scheduled, which keeps the simulation deterministic.
+    std::stable_sort(m_Due.begin(), m_Due.end(),
+        [](const Entry& a, const Entry& b) { return a.m_DueTime < b.m_DueTime; });
+
+    // The handlers may schedule more events (including into the current
+    // slot), so copy the list out before we fire anything.
+    assert(m_NumPending >= m_Due.size());
+    m_NumPending -= m_Due.size();
+    m_Cascade.swap(m_Due);
+    m_Due.clear();
+    for (const Entry& e : m_Cascade)
+    {
+        e.m_pEvent->onTimer(now);
+    }
+    m_Cascade.clear();
+}
+
+unsigned long long TimingWheel::slotOf(float t) const
+{
+    if (t <= 0.f)
+        return 0;
+    return (unsigned long long)std::floor(t / m_SlotDuration);
+}
+
+void TimingWheel::insert(const Entry& e)
+{
+    // Anything that's already overdue goes in the current slot.
+    const unsigned long long slot = std::max(slotOf(e.m_DueTime), m_CurSlot);
+
+    if ((slot >> kSlotBits) == (m_CurSlot >> kSlotBits))
+    {
+        m_Level0[slot & kSlotMask].push_back(e);
+    }
+    else if ((slot >> (2 * kSlotBits)) == (m_CurSlot >> (2 * kSlotBits)))
+    {
+        m_Level1[(slot >> kSlotBits) & kSlotMask].push_back(e);
+    }
+    else
+    {
+        m_Overflow.push_back(e);
+    }
+}
+
+void TimingWheel::cascade()
+{
+    // We just crossed into a new level 0 revolution.  If that also wrapped 
+    // level 1, then first redistribute the overflow list.
+    if (((m_CurSlot >> kSlotBits) & kSlotMask) == 0)
+    {
+        m_Cascade.swap(m_Overflow);
+        for (const Entry& e : m_Cascade)
+        {
+            insert(e);
+        }
+        m_Cascade.clear();
+    }
+
+    // Then bring the level 1 bucket for this revolution down into level 0.
+    Bucket& bucket = m_Level1[(m_CurSlot >> kSlotBits) & kSlotMask];
+    m_Cascade.swap(bucket);
+    for (const Entry& e : m_Cascade)
+    {
+        insert(e);
+    }
+    m_Cascade.clear();
+}
@@ -0,0 +1,98 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+// Anything that wants to be woken up by the TimingWheel implements this.
+class iTimedEvent
+{
+public:
+    virtual ~iTimedEvent() {}
+
+    // Called once the event's due time has passed.  now is the current game
+    // time (in seconds).
+    virtual void onTimer(float now) = 0;
+};
+
+// A two level hierarchical timing wheel.  Events are bucketed by the slot 
+// that contains their due time, so the cost of advancing the wheel scales
+// with the number of events that come due (and the number of slots crossed),
+// rather than with the number of events that are waiting.
+//  - Level 0 covers the next kNumSlots slots, one slot per bucket.
+//  - Level 1 covers the next kNumSlots * kNumSlots slots, kNumSlots per bucket.
+//    Its buckets are cascaded down into level 0 as we reach them.
+//  - Anything further out than that goes on an overflow list, which is
+//    cascaded each time level 1 wraps.
+class TimingWheel
+{
+public:
+    // slotDurationSec should be on the order of a tick (see TICK_MIN).
+    explicit TimingWheel(float slotDurationSec);
+
+    // Schedule pEvent to fire on the first advance() where now > dueTime.
+    // Events that are already due fire on the next advance().
+    // NOTE: The wheel does not own the event - it must stay alive until it fires.
+    void schedule(float dueTime, iTimedEvent* pEvent);
+
+    // Move the wheel forward to now, firing every event that has come due.
+    // Events fire in due time order within a slot, and slot by slot.
+    void advance(float now);
+
+    size_t getNumPending() const { return m_NumPending; }
+
+private:
+    struct Entry
+    {
+        float m_DueTime;
+        iTimedEvent* m_pEvent;
+    };
+    typedef std::vector<Entry> Bucket;
+
+    static const unsigned int kSlotBits = 6;
+    static const unsigned int kNumSlots = 1 << kSlotBits;
+    static const unsigned int kSlotMask = kNumSlots - 1;
+
+    unsigned long long slotOf(float t) const;
+
+    void insert(const Entry& e);
+    void cascade();
+
+private:
+    float m_SlotDuration;
+
+    // The slot that we're currently in.  Every slot before this one has been
+    // fully processed.
+    unsigned long long m_CurSlot;
+
+    Bucket m_Level0[kNumSlots];
+    Bucket m_Level1[kNumSlots];
+    Bucket m_Overflow;
+
+    // Scratch space for advance(), kept around so that we don't allocate
+    Bucket m_Due;
+    Bucket m_Cascade;
+
+    size_t m_NumPending;
+};
@@ -0,0 +1,70 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ArenaLayout.h"
+#include "Constants.h"
+
+ArenaLayout::ArenaLayout()
+    : m_Width(GAME_GRID_WIDTH)
+    , m_Height(GAME_GRID_HEIGHT)
+    , m_RiverTopY(RIVER_TOP_Y)
+    , m_RiverBotY(RIVER_BOT_Y)
+    , m_BridgeWidth(BRIDGE_WIDTH)
+    , m_BridgeHeight(BRIDGE_HEIGHT)
+    , m_LeftBridgeX(LEFT_BRIDGE_CENTER_X)
+    , m_KingY(NorthKingY)
+    , m_PrincessY(NorthPrincessY)
+{
+}
+
+ArenaLayout::ArenaLayout(int width, int height)
+    : m_Width(width)
+    , m_Height(height)
+    , m_RiverTopY((float)height / 2.f - (RIVER_BOT_Y - RIVER_TOP_Y) / 2.f)
+    , m_RiverBotY((float)height / 2.f + (RIVER_BOT_Y - RIVER_TOP_Y) / 2.f)
+    , m_BridgeWidth(BRIDGE_WIDTH * (float)width / (float)GAME_GRID_WIDTH)
+    , m_BridgeHeight(BRIDGE_HEIGHT)
+    , m_LeftBridgeX(LEFT_BRIDGE_CENTER_X * (float)width / (float)GAME_GRID_WIDTH)
+    , m_KingY(NorthKingY)
+    , m_PrincessY(NorthPrincessY)
+{
+}
+
+Vec2 ArenaLayout::getKingPos(bool bNorth) const
+{
+    return Vec2((float)m_Width / 2.f, bNorth ? m_KingY : (float)m_Height - m_KingY);
+}
+
+Vec2 ArenaLayout::getPrincessPos(bool bNorth, bool bLeft) const
+{
+    return Vec2(getBridgeCenterX(bLeft), bNorth ? m_PrincessY : (float)m_Height - m_PrincessY);
+}
+
+Vec2 ArenaLayout::playerToGame(const Vec2& pos, bool bPlayerIsNorth) const
+{
+    if (!bPlayerIsNorth)
+    {
+        return Vec2(pos.x, Real(m_Height) - pos.y);
+    }
+
+    return pos;
+}
@@ -0,0 +1,78 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// The size of the arena, and where the river, bridges and towers are in it.
+// The constants in Constants.h describe the standard (18x32) arena, which is
+// what you get by default, but a Game can be given any size - use this 
+// (see iPlayer::getLayout()) rather than the constants if you want your 
+// code to work on all of them.
+
+#include "Vec2.h"
+
+class ArenaLayout
+{
+public:
+    // The standard arena, exactly as in Constants.h.
+    ArenaLayout();
+
+    // An arena of the given size (in tiles), laid out like the standard one.
+    // The lanes and bridges stretch with the width, while the river and the
+    // distance from the towers to the back edge stay the same.  The width 
+    // should be even.
+    ArenaLayout(int width, int height);
+
+    int getWidth() const { return m_Width; }
+    int getHeight() const { return m_Height; }
+
+    float getRiverTopY() const { return m_RiverTopY; }
+    float getRiverBotY() const { return m_RiverBotY; }
+
+    float getBridgeWidth() const { return m_BridgeWidth; }
+    float getBridgeHeight() const { return m_BridgeHeight; }
+    float getBridgeCenterY() const { return (float)m_Height / 2.f; }
+    float getBridgeCenterX(bool bLeft) const { return bLeft ? m_LeftBridgeX : (float)m_Width - m_LeftBridgeX; }
+
+    Vec2 getKingPos(bool bNorth) const;
+    Vec2 getPrincessPos(bool bNorth, bool bLeft) const;
+
+    // Is a (tile centered) position somewhere that side can place mobs?
+    bool isValidPlacementX(Real x) const { return (x > Real(0)) && (x < Real(m_Width)); }
+    bool isValidPlacementY(Real y, bool bNorth) const 
+        { return bNorth ? ((y > Real(0)) && (y < Real(m_RiverTopY)))
+                        : ((y > Real(m_RiverBotY)) && (y < Real(m_Height))); }
+
+    // Like Vec2::Player2Game(), but for this arena.
+    Vec2 playerToGame(const Vec2& pos, bool bPlayerIsNorth) const;
+
+private:
+    int m_Width;
+    int m_Height;
+    float m_RiverTopY;
+    float m_RiverBotY;
+    float m_BridgeWidth;
+    float m_BridgeHeight;
+    float m_LeftBridgeX;        // and the left princess towers
+    float m_KingY;              // north's, measured from the top edge
+    float m_PrincessY;
+};
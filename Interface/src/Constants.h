@@ -23,6 +23,10 @@
 #pragma once
 #include "Vec2.h"
 
+// NOTE: The grid, river, bridge and tower constants describe the standard 
+// arena.  A Game can be given a different one (see ArenaLayout), so the game
+// code itself gets them from its ArenaLayout rather than from here.
+
 //Screen dimension constants
 const int PIXELS_PER_METER = 30; // The width of a game grid tile
 
@@ -63,6 +67,9 @@ const float WAYPOINT_LEFT_X = LEFT_BRIDGE_CENTER_X;
 const float WAYPOINT_RIGHT_X = RIGHT_BRIDGE_CENTER_X;
 const float WAYPOINT_Y_INCREMENT = 2.f;
 
+// How fast the projectiles from ranged attacks fly, in meters per second.
+const float PROJECTILE_SPEED = 12.f;
+
 // Tick limitations
 const float TICK_MIN = 0.05f;
 const float TICK_MAX = 0.2f;
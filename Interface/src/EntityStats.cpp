@@ -23,9 +23,12 @@
 #include "EntityStats.h"
 
 #include <assert.h>
+#include <limits.h>
+#include <stddef.h>
 #include <unordered_map>
+#include <vector>
 
-class EntityStats_Rogue : public iEntityStats_Mob
+class EntityStats_Rogue : public iEntityStats_Rogue
 {
 public:
     virtual MobType getMobType() const { return Rogue; }
@@ -43,12 +46,11 @@ public:
     virtual const char* getName() const { return "Rogue"; }
     virtual const char* getDisplayLetter() const { return "R"; }
 
-    virtual bool canSpringAttack() { return true; }
-    virtual float getSpringRange() { return 2.5; }
-    virtual float getSpringSpeed() { return 15; }
-    virtual float getSpringAttackDamage() { return 1000; }
-    virtual float perferGiantRange() { return 2.f; }
-    virtual float getHideDistance() { return 0.5f; }
+    virtual float getSpringRange() const { return 2.5; }
+    virtual float getSpringSpeed() const { return 15; }
+    virtual float getSpringAttackDamage() const { return 1000; }
+    virtual float perferGiantRange() const { return 2.f; }
+    virtual float getHideDistance() const { return 0.5f; }
 };
 
 class EntityStats_Swordsman : public iEntityStats_Mob
@@ -184,6 +186,11 @@ const iEntityStats& iEntityStats::getStats(MobType t)
 }
 
 
+const iEntityStats_Rogue& iEntityStats::getRogueStats()
+{
+    return static_cast<const iEntityStats_Rogue&>(getStats(Rogue));
+}
+
 const iEntityStats& iEntityStats::getBuildingStats(BuildingType t)
 {
     // NOTE: This vector must be in synch with the MobType enum (in the .h)
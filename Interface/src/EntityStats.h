@@ -27,8 +27,11 @@
 // values are in EntityStats.cpp. 
 
 #include <assert.h>
+#include <float.h>
 #include <limits>
 
+class iEntityStats_Rogue;
+
 // Stats that each mob needs to have.  
 class iEntityStats
 {
@@ -74,6 +77,10 @@ public:
     static const iEntityStats& getStats(MobType t);
     static const iEntityStats& getBuildingStats(BuildingType t);
 
+    // Project 2: The Rogue's extra stats (for hiding and spring attacks).  No
+    // other mob has them, so they get an interface of their own.
+    static const iEntityStats_Rogue& getRogueStats();
+
     virtual MobType getMobType() const = 0;
     virtual BuildingType getBuildingType() const = 0;
 
@@ -90,18 +97,6 @@ public:
     virtual float getSightRadius() const = 0;
     virtual const char* getName() const = 0;
     virtual const char* getDisplayLetter() const = 0;
-
-    // Project 2: Note these new functions.  You can use them to get stats for the Rogue,
-    // but (with the exception of canSpringAttack()) you should only call them if the 
-    // MobType actually is Rogue (otherwise the asserts will fire).
-
-    // Special values for the Rogue.
-    virtual bool canSpringAttack() { return false; }
-    virtual float getSpringRange() { assert(false && "Mob is not a rogue!"); return 0.f; }
-    virtual float getSpringSpeed() { assert(false && "Mob is not a rogue!"); return 0.f; }
-    virtual float getSpringAttackDamage() { assert(false && "Mob is not a rogue!"); return 0.f; }
-    virtual float perferGiantRange() { assert(false && "Mob is not a rogue!"); return 0.f; }
-    virtual float getHideDistance() { assert(false && "Mob is not a rogue!"); return 0; }
 };
 
 class iEntityStats_Mob : public iEntityStats
@@ -123,3 +118,13 @@ public:
     virtual float getSpeed() const { assert(false); return FLT_MAX; }
     virtual float getMass() const { assert(false); return FLT_MAX; }
 };
+
+class iEntityStats_Rogue : public iEntityStats_Mob
+{
+public:
+    virtual float getSpringRange() const = 0;
+    virtual float getSpringSpeed() const = 0;
+    virtual float getSpringAttackDamage() const = 0;
+    virtual float perferGiantRange() const = 0;
+    virtual float getHideDistance() const = 0;
+};
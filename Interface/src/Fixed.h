@@ -0,0 +1,109 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// A deterministic fixed point number, with 16 fractional bits.  The math is
+// all done with integers, so the results are bit-for-bit identical on every
+// compiler and with every set of floating point flags.
+// NOTE: The value is stored in 64 bits (i.e. Q47.16, rather than Q15.16) so
+// that squared distances don't overflow on big arenas.  It's no slower on 
+// a 64 bit CPU.
+
+#include <cmath>
+#include <iostream>
+#include <stdint.h>
+
+class Fixed
+{
+public:
+    static const int kFracBits = 16;
+    static const int64_t kOne = (int64_t)1 << kFracBits;
+
+    Fixed() : m_Raw(0) {}
+    Fixed(int i) : m_Raw((int64_t)i * kOne) {}
+    Fixed(float f) : m_Raw(fromDouble((double)f)) {}
+    Fixed(double d) : m_Raw(fromDouble(d)) {}
+
+    static Fixed fromRaw(int64_t raw) { Fixed f; f.m_Raw = raw; return f; }
+    static Fixed max() { return fromRaw(INT64_MAX); }
+
+    int64_t getRaw() const { return m_Raw; }
+
+    // Conversions out are explicit, so that mixed expressions (e.g. 
+    // Fixed * float) always do their math in fixed point.
+    explicit operator float() const { return (float)m_Raw / (float)kOne; }
+    explicit operator double() const { return (double)m_Raw / (double)kOne; }
+    explicit operator int() const { return (int)(m_Raw / kOne); }   // truncates, like (int)float
+
+    Fixed operator-() const { return fromRaw(-m_Raw); }
+
+    Fixed& operator+=(Fixed rhs) { m_Raw += rhs.m_Raw; return *this; }
+    Fixed& operator-=(Fixed rhs) { m_Raw -= rhs.m_Raw; return *this; }
+    Fixed& operator*=(Fixed rhs) { m_Raw = mul(m_Raw, rhs.m_Raw); return *this; }
+    Fixed& operator/=(Fixed rhs) { m_Raw = div(m_Raw, rhs.m_Raw); return *this; }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.m_Raw + b.m_Raw); }
+    friend Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.m_Raw - b.m_Raw); }
+    friend Fixed operator*(Fixed a, Fixed b) { return fromRaw(mul(a.m_Raw, b.m_Raw)); }
+    friend Fixed operator/(Fixed a, Fixed b) { return fromRaw(div(a.m_Raw, b.m_Raw)); }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.m_Raw == b.m_Raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.m_Raw != b.m_Raw; }
+    friend bool operator<(Fixed a, Fixed b) { return a.m_Raw < b.m_Raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.m_Raw <= b.m_Raw; }
+    friend bool operator>(Fixed a, Fixed b) { return a.m_Raw > b.m_Raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.m_Raw >= b.m_Raw; }
+
+    // Rounds down to the nearest representable value.
+    friend Fixed sqrt(Fixed f) 
+    { 
+        if (f.m_Raw <= 0)
+            return Fixed();
+        return fromRaw((int64_t)isqrt((uint64_t)f.m_Raw << kFracBits));
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, Fixed f) { return os << (double)f; }
+
+private:
+    static int64_t fromDouble(double d) { return (int64_t)std::llround(d * (double)kOne); }
+
+    // Round down on multiply, toward zero on divide.
+    static int64_t mul(int64_t a, int64_t b) { return (a * b) >> kFracBits; }
+    static int64_t div(int64_t a, int64_t b) { return (b == 0) ? ((a < 0) ? -INT64_MAX : INT64_MAX) : (a * kOne) / b; }
+
+    // floor(sqrt(n)).  The hardware square root gives us a very good guess,
+    // and then we fix it up with integer math, so the result is exact (and
+    // therefore the same everywhere) no matter how the guess was rounded.
+    static uint64_t isqrt(uint64_t n)
+    {
+        const uint64_t kMaxRoot = 0xFFFFFFFFull;
+        uint64_t r = (uint64_t)std::sqrt((double)n);
+        if (r > kMaxRoot) r = kMaxRoot;
+        while (r * r > n) --r;
+        while ((r < kMaxRoot) && ((r + 1) * (r + 1) <= n)) ++r;
+        return r;
+    }
+
+private:
+    int64_t m_Raw;
+};
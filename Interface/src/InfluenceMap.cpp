@@ -0,0 +1,193 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "InfluenceMap.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+InfluenceMap::Stamp::Stamp()
+    : m_TileX(0)
+    , m_TileY(0)
+    , m_Dps(0)
+    , m_Reach(0.f)
+    , m_Health(0)
+    , m_bStamped(false)
+{
+}
+
+InfluenceMap::InfluenceMap()
+    : m_Width(0)
+    , m_Height(0)
+{
+}
+
+InfluenceMap::InfluenceMap(const ArenaLayout& layout)
+    : m_Width(layout.getWidth())
+    , m_Height(layout.getHeight())
+    , m_Dps(m_Width * m_Height, 0)
+    , m_Health(m_Width * m_Height, 0)
+{
+}
+
+int InfluenceMap::getTileX(Real x) const
+{
+    return std::min(std::max((int)floorf((float)x), 0), m_Width - 1);
+}
+
+int InfluenceMap::getTileY(Real y) const
+{
+    return std::min(std::max((int)floorf((float)y), 0), m_Height - 1);
+}
+
+void InfluenceMap::update(Stamp& stamp, const iEntityStats& stats, const Vec2& pos, int health)
+{
+    if (health <= 0)
+    {
+        remove(stamp);
+        return;
+    }
+
+    const int tileX = getTileX(pos.x);
+    const int tileY = getTileY(pos.y);
+    if (stamp.m_bStamped && (stamp.m_TileX == tileX) && (stamp.m_TileY == tileY))
+    {
+        // Same footprint (an entity's stats never change), so at most our 
+        // health has changed, which is only one tile.  This is almost every
+        // entity on almost every tick.
+        m_Health[index(tileX, tileY)] += health - stamp.m_Health;
+        stamp.m_Health = health;
+        return;
+    }
+
+    Stamp next;
+    next.m_TileX = tileX;
+    next.m_TileY = tileY;
+    next.m_Dps = (int)lroundf((float)stats.getDamage() / stats.getAttackTime() * (float)ksDpsScale);
+    // We only know which tile we're in, not where in it, so reach an extra 
+    // half a tile to cover the far side of it.
+    next.m_Reach = stats.getAttackRange() + (stats.getSize() / 2.f) + 0.5f;
+    next.m_Health = health;
+    next.m_bStamped = true;
+
+    restamp(stamp, next);
+    stamp = next;
+}
+
+void InfluenceMap::remove(Stamp& stamp)
+{
+    restamp(stamp, Stamp());
+    stamp.m_bStamped = false;
+}
+
+void InfluenceMap::clear()
+{
+    std::fill(m_Dps.begin(), m_Dps.end(), 0);
+    std::fill(m_Health.begin(), m_Health.end(), 0);
+}
+
+bool InfluenceMap::getSpan(const Stamp& stamp, int y, int& minX, int& maxX) const
+{
+    // Every tile whose center is within reach of the center of ours.  This
+    // only depends on the stamp, so taking it out again always visits 
+    // exactly the same tiles.
+    if (!stamp.m_bStamped)
+        return false;
+
+    const int dy = y - stamp.m_TileY;
+    const float dxSqr = (stamp.m_Reach * stamp.m_Reach) - (float)(dy * dy);
+    if (dxSqr < 0.f)
+        return false;
+
+    const int maxDX = (int)sqrtf(dxSqr);
+    minX = std::max(stamp.m_TileX - maxDX, 0);
+    maxX = std::min(stamp.m_TileX + maxDX, m_Width - 1);
+    return true;
+}
+
+void InfluenceMap::addDps(int y, int minX, int maxX, int dps)
+{
+    int* pRow = &m_Dps[index(0, y)];
+    for (int x = minX; x <= maxX; ++x)
+    {
+        pRow[x] += dps;
+    }
+}
+
+void InfluenceMap::restamp(const Stamp& from, const Stamp& to)
+{
+    if (from.m_bStamped)
+        m_Health[index(from.m_TileX, from.m_TileY)] -= from.m_Health;
+    if (to.m_bStamped)
+        m_Health[index(to.m_TileX, to.m_TileY)] += to.m_Health;
+
+    int minY = m_Height;
+    int maxY = -1;
+    for (const Stamp* pStamp : { &from, &to })
+    {
+        if (pStamp->m_bStamped)
+        {
+            minY = std::min(minY, std::max(pStamp->m_TileY - (int)pStamp->m_Reach, 0));
+            maxY = std::max(maxY, std::min(pStamp->m_TileY + (int)pStamp->m_Reach, m_Height - 1));
+        }
+    }
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        int fromMinX, fromMaxX, toMinX, toMaxX;
+        const bool bFrom = getSpan(from, y, fromMinX, fromMaxX);
+        const bool bTo = getSpan(to, y, toMinX, toMaxX);
+
+        if (bFrom && bTo && (from.m_Dps == to.m_Dps))
+        {
+            // Only touch the ends that differ.  When an entity steps into the
+            // next tile, that's a tile or two per row, rather than the whole
+            // area twice over.
+            addDps(y, fromMinX, std::min(fromMaxX, toMinX - 1), -from.m_Dps);
+            addDps(y, std::max(fromMinX, toMaxX + 1), fromMaxX, -from.m_Dps);
+            addDps(y, toMinX, std::min(toMaxX, fromMinX - 1), to.m_Dps);
+            addDps(y, std::max(toMinX, fromMaxX + 1), toMaxX, to.m_Dps);
+        }
+        else
+        {
+            if (bFrom)
+                addDps(y, fromMinX, fromMaxX, -from.m_Dps);
+            if (bTo)
+                addDps(y, toMinX, toMaxX, to.m_Dps);
+        }
+    }
+}
+
+void InfluenceMap::swap(InfluenceMap& rhs)
+{
+    std::swap(m_Width, rhs.m_Width);
+    std::swap(m_Height, rhs.m_Height);
+    m_Dps.swap(rhs.m_Dps);
+    m_Health.swap(rhs.m_Health);
+}
+
+bool InfluenceMap::operator==(const InfluenceMap& rhs) const
+{
+    return (m_Width == rhs.m_Width) && (m_Height == rhs.m_Height) 
+        && (m_Dps == rhs.m_Dps) && (m_Health == rhs.m_Health);
+}
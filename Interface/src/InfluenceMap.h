@@ -0,0 +1,113 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Final Project: How much pressure one side is putting on each tile of the 
+// arena.  For every tile this has:
+//   - The damage per second of all of that side's entities (mobs and towers)
+//     that can hit something in that tile from where they are now.
+//   - The total health of that side's entities standing in that tile.
+// Get one for each side from iPlayer::getInfluence() and 
+// iPlayer::getOpponentInfluence().  The game keeps them up to date as it 
+// goes (an entity only costs anything when it moves to a different tile,
+// takes damage, spawns or dies), so reading them is free.
+
+#include "ArenaLayout.h"
+#include "EntityStats.h"
+#include "Vec2.h"
+
+#include <vector>
+
+class InfluenceMap
+{
+public:
+    // DPS is stored in hundredths, so that adding an entity in and taking it
+    // back out again always leaves exactly what was there before.
+    static const int ksDpsScale = 100;
+
+    // What one entity has added to the map, so that the game can take it 
+    // back out again.  Each entity has one of these.
+    struct Stamp
+    {
+        int m_TileX;
+        int m_TileY;
+        int m_Dps;              // scaled by ksDpsScale
+        float m_Reach;          // in tiles
+        int m_Health;
+        bool m_bStamped;
+
+        Stamp();
+    };
+
+    InfluenceMap();
+    explicit InfluenceMap(const ArenaLayout& layout);
+
+    // One tile per square meter, so the map is the same size as the arena.
+    int getWidth() const { return m_Width; }
+    int getHeight() const { return m_Height; }
+
+    int getTileX(Real x) const;
+    int getTileY(Real y) const;
+
+    // Damage per second that could land on tile (x, y), or on the tile 
+    // containing pos.
+    float getDps(int x, int y) const { return (float)m_Dps[index(x, y)] / (float)ksDpsScale; }
+    float getDps(const Vec2& pos) const { return getDps(getTileX(pos.x), getTileY(pos.y)); }
+
+    // Total health of the entities in tile (x, y), or in the tile containing
+    // pos.
+    int getHealth(int x, int y) const { return m_Health[index(x, y)]; }
+    int getHealth(const Vec2& pos) const { return getHealth(getTileX(pos.x), getTileY(pos.y)); }
+
+    // The game uses these to keep the map up to date.  update() moves 
+    // stamp to where an entity with the given stats, position and health 
+    // now is (or takes it out if health <= 0).  A stamp must always be 
+    // updated with the same stats.
+    void update(Stamp& stamp, const iEntityStats& stats, const Vec2& pos, int health);
+    void remove(Stamp& stamp);
+    void clear();
+
+    // Cheaply exchange contents with another map.
+    void swap(InfluenceMap& rhs);
+
+    bool operator==(const InfluenceMap& rhs) const;
+    bool operator!=(const InfluenceMap& rhs) const { return !(*this == rhs); }
+
+private:
+    int index(int x, int y) const { return (y * m_Width) + x; }
+
+    // The tiles in row y that stamp reaches are minX to maxX (inclusive).
+    // Returns false if it doesn't reach that row at all.
+    bool getSpan(const Stamp& stamp, int y, int& minX, int& maxX) const;
+    void addDps(int y, int minX, int maxX, int dps);
+
+    // Takes from out of the map and puts to in, only touching the tiles 
+    // where they differ.  Either can be unstamped.
+    void restamp(const Stamp& from, const Stamp& to);
+
+private:
+    int m_Width;
+    int m_Height;
+    std::vector<int> m_Dps;             // scaled by ksDpsScale
+    std::vector<int> m_Health;
+};
@@ -0,0 +1,48 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Real is the number type that the simulation uses for positions, distances
+// and anything else that goes into a Vec2.  By default it's a float.  If 
+// CRASHLOYAL_FIXED_POINT is defined then it's a Fixed instead, which makes 
+// the simulation bit-for-bit deterministic across compilers and build flags
+// (e.g. for replays).  
+// NOTE: If you define it, define it for every project in the solution!
+
+//#define CRASHLOYAL_FIXED_POINT
+
+#include <float.h>
+
+#ifdef CRASHLOYAL_FIXED_POINT
+
+#include "Fixed.h"
+typedef Fixed Real;
+const Real REAL_MAX = Fixed::max();
+
+#else
+
+#include <cmath>
+typedef float Real;
+const Real REAL_MAX = FLT_MAX;
+
+#endif
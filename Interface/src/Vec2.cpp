@@ -23,16 +23,21 @@
 #include "Vec2.h"
 #include "Constants.h"
 
-float Vec2::normalize() 
+Real Vec2::normalize() 
 {
-    const float mag = length();
-    if (mag <= 0.00001f)
+    const Real mag = length();
+    if (mag <= Real(0.00001f))
     { 
-        x = y = 0.f;
-        return 0.f; 
+        x = y = Real(0);
+        return Real(0); 
     }
 
+#ifdef CRASHLOYAL_FIXED_POINT
+    // Integer division is slow, so only do it once.
+    *this *= (Real(1) / mag);
+#else
     *this /= mag;
+#endif
     return mag;
 }
 
@@ -40,7 +45,7 @@ Vec2 Vec2::Player2Game(bool bPlayerIsNorth) const
 { 
     if (!bPlayerIsNorth) 
     {
-        return Vec2(x, GAME_GRID_HEIGHT - y);
+        return Vec2(x, Real(GAME_GRID_HEIGHT) - y);
     }
 
     return *this;
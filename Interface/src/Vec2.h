@@ -22,18 +22,23 @@
 
 #pragma once
 
+#include "Real.h"
+
 #include <cmath>
 #include <iostream>
 #include <stdio.h>
 
 class Vec2 {
 public:
-    float x;
-    float y;
+    Real x;
+    Real y;
 
-    Vec2() : x(-FLT_MAX), y(-FLT_MAX) {}
-    Vec2(int inX, int inY) : x((float)inX), y((float)inY) {}
+    Vec2() : x(-REAL_MAX), y(-REAL_MAX) {}
+    Vec2(int inX, int inY) : x(Real(inX)), y(Real(inY)) {}
     Vec2(float inX, float inY) : x(inX), y(inY) {}
+#ifdef CRASHLOYAL_FIXED_POINT
+    Vec2(Real inX, Real inY) : x(inX), y(inY) {}
+#endif
     Vec2(const Vec2& rhs) : x(rhs.x), y(rhs.y) {}
 
     bool operator==(const Vec2& rhs) const { return (x == rhs.x) && (y == rhs.y); }
@@ -47,25 +52,26 @@ public:
     Vec2 operator-(const Vec2& rhs) const { return Vec2(x - rhs.x, y - rhs.y); }
     Vec2& operator-=(const Vec2& rhs) { x -= rhs.x; y -= rhs.y; return *this; }
 
-    Vec2 operator*(const float f) const { return Vec2(x * f, y * f); }
-    Vec2& operator*=(const float f) { x *= f; y *= f; return *this; }
+    Vec2 operator*(const Real f) const { return Vec2(x * f, y * f); }
+    Vec2& operator*=(const Real f) { x *= f; y *= f; return *this; }
 
-    Vec2 operator/(const float f) const { return Vec2(x / f, y / f); }
-    Vec2& operator/=(const float f) { x /= f; y /= f; return *this; }
+    Vec2 operator/(const Real f) const { return Vec2(x / f, y / f); }
+    Vec2& operator/=(const Real f) { x /= f; y /= f; return *this; }
 
-    float lengthSqr() const { return x * x + y * y; }
-    float length() const { return sqrt(lengthSqr()); }
+    Real lengthSqr() const { return x * x + y * y; }
+    Real length() const { return sqrt(lengthSqr()); }
 
-    float distSqr(Vec2 other) const { return (other - *this).lengthSqr(); }
-    float dist(Vec2 other) const { return (other - *this).length(); }
+    Real distSqr(Vec2 other) const { return (other - *this).lengthSqr(); }
+    Real dist(Vec2 other) const { return (other - *this).length(); }
 
     // Returns the previous length.  If the length is too short to normalize,
     //  sets the vector to (0,0) and returns 0.
-    float normalize();
+    Real normalize();
 
     // Final Project: These helper functions can convert between Player coordinates
     // (which have the player's towers at the y=0 end of the field) and Game 
     // coordinates (with the north player on the y = 0 side of the field) 
+    // NOTE: This assumes the standard arena - see ArenaLayout::playerToGame().
     Vec2 Player2Game(bool bPlayerIsNorth) const;
 
 private:
@@ -29,6 +29,7 @@
 // it is time for the controler to do its work.
 
 #include <assert.h>
+#include <chrono>
 #include "SDL.h"
 
 class iPlayer;
@@ -46,6 +47,14 @@ public:
     // seconds, and in game time) since the last tick.
     virtual void tick(float deltaTSec) = 0;
 
+    // Final Project: This is optional.  When the game has time to spare 
+    // before the next tick, it offers it to the controllers by calling this.
+    // It's a good place for anytime algorithms (e.g. MCTS or iterative 
+    // deepening) to keep improving their plan.  Return by the deadline, or
+    // you'll hold up the next tick!  You can't place mobs from here - do 
+    // that from tick().
+    virtual void think(std::chrono::steady_clock::time_point /*deadline*/) {}
+
 protected:
     iPlayer* m_pPlayer; // NOT owned, guaranteed to exist when tick() is called
 
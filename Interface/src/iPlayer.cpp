@@ -22,6 +22,8 @@
 
 #include "iPlayer.h"
 
+#include <limits.h>
+
 const Vec2 ksInvalidPos;
 
 
@@ -47,4 +49,62 @@ iPlayer::EntityData::EntityData(const EntityData& rhs)
 {
 }
 
+// These look at every mob.  The game's Player has a spatial index, and 
+// overrides them to use that instead.
+
+unsigned int iPlayer::findMobsInCircle(bool bOpponent, const Vec2& center, float radius, 
+                                       unsigned int* pOut, unsigned int maxCount) const
+{
+    const Real radiusSq = Real(radius) * Real(radius);
+    const unsigned int numMobs = bOpponent ? getNumOpponentMobs() : getNumMobs();
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < numMobs; ++i)
+    {
+        const EntityData mob = bOpponent ? getOpponentMob(i) : getMob(i);
+        if (mob.m_Position.distSqr(center) <= radiusSq)
+        {
+            if (count < maxCount)
+                pOut[count] = i;
+            ++count;
+        }
+    }
+    return count;
+}
+
+unsigned int iPlayer::findMobsInRect(bool bOpponent, const Vec2& minCorner, const Vec2& maxCorner, 
+                                     unsigned int* pOut, unsigned int maxCount) const
+{
+    const unsigned int numMobs = bOpponent ? getNumOpponentMobs() : getNumMobs();
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < numMobs; ++i)
+    {
+        const Vec2& pos = (bOpponent ? getOpponentMob(i) : getMob(i)).m_Position;
+        if ((pos.x >= minCorner.x) && (pos.x <= maxCorner.x) && (pos.y >= minCorner.y) && (pos.y <= maxCorner.y))
+        {
+            if (count < maxCount)
+                pOut[count] = i;
+            ++count;
+        }
+    }
+    return count;
+}
 
+int iPlayer::findNearestOpponentMob(const Vec2& pos, iEntityStats::MobType type) const
+{
+    int best = -1;
+    Real bestDistSq(0);
+    for (unsigned int i = 0; i < getNumOpponentMobs(); ++i)
+    {
+        const EntityData mob = getOpponentMob(i);
+        if ((type != iEntityStats::InvalidMobType) && (mob.m_Stats.getMobType() != type))
+            continue;
+
+        const Real distSq = mob.m_Position.distSqr(pos);
+        if ((best < 0) || (distSq < bestDistSq))
+        {
+            best = (int)i;
+            bestDistSq = distSq;
+        }
+    }
+    return best;
+}
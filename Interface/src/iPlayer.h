@@ -27,7 +27,9 @@
 // query into the state of your player and the opposing player, and to control 
 // your player.
 
+#include "ArenaLayout.h"
 #include "EntityStats.h"
+#include "InfluenceMap.h"
 #include "Vec2.h"
 #include <vector>
 
@@ -45,6 +47,11 @@ public:
     // like placing units, so that you place them on the right side.
     virtual bool isNorth() const = 0;
 
+    // Final Project: How big the arena is, and where the river, bridges and
+    // towers are.  It's usually the standard arena from Constants.h, but it
+    // doesn't have to be.
+    virtual const ArenaLayout& getLayout() const = 0;
+
     // Final Project: Call this to find out how much elixir you currently have.
     // You can look in Constants.h to see how much you start with, what the 
     // maximum is and how fast it accumulates.
@@ -67,6 +74,16 @@ public:
     };
     virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos) = 0;
 
+    // Final Project: If you want to place several mobs in one tick (or try 
+    // out lots of options), you can queue them up instead.  Once both 
+    // players' controllers have ticked, each player's queue is checked and
+    // placed in the order you queued it, with the same checks as placeMob().
+    // queuePlacement() returns the index of the placement's result in 
+    // getPlacementResults(), which holds the results of the last batch
+    // until the next one is placed (so you'll see them on your next tick).
+    virtual unsigned int queuePlacement(iEntityStats::MobType type, const Vec2& pos) = 0;
+    virtual const std::vector<PlacementResult>& getPlacementResults() const = 0;
+
     // Final Project: Use these interfaces to get data about your own entities and/or
     // the opposing player's entities.
     // NOTE: When getting buildings or mobs, you are responsible for ensuring you pass
@@ -92,6 +109,30 @@ public:
     virtual unsigned int getNumOpponentMobs() const = 0;
     virtual EntityData getOpponentMob(unsigned int i) const = 0;
 
+    // Final Project: Use these to find the mobs in an area without looking at
+    // all of them.  The first two fill pOut (which must have room for 
+    // maxCount) with the indices of the mobs in the circle or rectangle 
+    // (edges included), for use with getMob() - or getOpponentMob() if 
+    // bOpponent is true.  They're in no particular order, and the return 
+    // value is how many there were in all, which may be more than maxCount.
+    // findNearestOpponentMob() returns the index of the opponent's mob of the
+    // given type (InvalidMobType for any type) closest to pos, or -1 if they 
+    // don't have one.  
+    // NOTE: These see the mobs as of the end of the last tick, so any you 
+    // placed this tick won't show up until the next one.  In the game
+    // they're answered from a spatial index, so they don't allocate.
+    virtual unsigned int findMobsInCircle(bool bOpponent, const Vec2& center, float radius, 
+                                          unsigned int* pOut, unsigned int maxCount) const;
+    virtual unsigned int findMobsInRect(bool bOpponent, const Vec2& minCorner, const Vec2& maxCorner, 
+                                        unsigned int* pOut, unsigned int maxCount) const;
+    virtual int findNearestOpponentMob(const Vec2& pos, iEntityStats::MobType type) const;
+
+    // Final Project: Where each side's damage and health are, tile by tile,
+    // as of the end of the last tick (see InfluenceMap.h).  Use these rather
+    // than adding it all up yourself from the entities.
+    virtual const InfluenceMap& getInfluence() const = 0;
+    virtual const InfluenceMap& getOpponentInfluence() const = 0;
+
 private:
     // DELIBERATELY UNDEFINED
     iPlayer(const iPlayer& rhs);
@@ -0,0 +1,132 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The aihost runs one controller in its own process, for Controller_Shm.  
+// It's started by the game (not by hand), with the shared memory channel on
+// Shm::kHostFd.  Usage:
+//    crashloyal_aihost <controller name>
+
+#include "Controller_AI_KevinDill.h"
+#include "ShmChannel.h"
+#include "ShmPlayer.h"
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <thread>
+#include <vector>
+
+// How long we sleep at a time while we wait for the game, before we check 
+// whether it's still there.
+static const int64_t ksParentCheckNs = 1000000000;
+
+static iController* createController(const char* name)
+{
+    if (strcmp(name, "KevinDill") == 0)
+        return new Controller_AI_KevinDill;
+
+    return NULL;
+}
+
+// We might have been started by a server with lots of sockets open.  We 
+// don't want to hold them open after the server closes them.
+static void closeInheritedFds()
+{
+    std::vector<int> fds;
+    if (DIR* pDir = opendir("/proc/self/fd"))
+    {
+        while (dirent* pEntry = readdir(pDir))
+        {
+            const int fd = atoi(pEntry->d_name);
+            if ((fd > Shm::kHostFd) && (fd != dirfd(pDir)))
+                fds.push_back(fd);
+        }
+        closedir(pDir);
+    }
+
+    for (int fd : fds) close(fd);
+}
+
+int main(int argc, char* args[])
+{
+    // If the game goes away, so do we.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    const pid_t parentPid = getppid();
+
+    closeInheritedFds();
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <controller name>\n", args[0]);
+        return 1;
+    }
+
+    iController* pControl = createController(args[1]);
+    if (!pControl)
+    {
+        fprintf(stderr, "%s: unknown controller %s\n", args[0], args[1]);
+        return 1;
+    }
+
+    void* pMem = mmap(NULL, sizeof(Shm::Channel), PROT_READ | PROT_WRITE, MAP_SHARED, Shm::kHostFd, 0);
+    if (pMem == MAP_FAILED)
+    {
+        fprintf(stderr, "%s: couldn't map the channel\n", args[0]);
+        return 1;
+    }
+
+    Shm::Channel& channel = *(Shm::Channel*)pMem;
+    if (channel.m_Magic != Shm::kMagic)
+    {
+        fprintf(stderr, "%s: bad channel\n", args[0]);
+        return 1;
+    }
+
+    ShmPlayer player(channel);
+    pControl->setPlayer(player);
+
+    const unsigned int numSpins = (std::thread::hardware_concurrency() > 1) ? 4000 : 0;
+    uint32_t lastTick = channel.m_Done.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (!Shm::spinWhileEqual(channel.m_Published, lastTick, numSpins))
+        {
+            Shm::futexWait(&channel.m_Published, lastTick, ksParentCheckNs);
+            if (getppid() != parentPid)
+                break;
+            continue;
+        }
+
+        // If we fell behind then this skips straight to the latest tick.
+        lastTick = player.readState();
+        pControl->tick(player.getDeltaTSec());
+
+        channel.m_Done.store(lastTick, std::memory_order_release);
+        Shm::futexWake(&channel.m_Done);
+    }
+
+    delete pControl;
+    return 0;
+}
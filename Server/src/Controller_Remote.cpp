@@ -0,0 +1,48 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Controller_Remote.h"
+
+void Controller_Remote::tick(float /*deltaTSec*/)
+{
+    assert(m_pPlayer);
+
+    for (const Placement& p : m_Queue)
+    {
+        // Don't trust the mob type - it came from outside the process.
+        if ((p.m_Type < 0) || (p.m_Type >= iEntityStats::numMobTypes))
+        {
+            m_Results.push_back(iPlayer::MobTypeUnavailable);
+            continue;
+        }
+
+        m_Results.push_back(m_pPlayer->placeMob(p.m_Type, p.m_Pos));
+    }
+
+    m_Queue.clear();
+}
+
+void Controller_Remote::queuePlacement(iEntityStats::MobType type, const Vec2& pos)
+{
+    Placement p = { type, pos };
+    m_Queue.push_back(p);
+}
@@ -0,0 +1,59 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "EntityStats.h"
+#include "iController.h"
+#include "iPlayer.h"
+#include "Vec2.h"
+
+#include <vector>
+
+// A controller whose decisions come from somewhere else (e.g. over a socket
+// from the MatchServer).  Placements are queued up between ticks, and then
+// made when the game ticks us.
+class Controller_Remote : public iController
+{
+public:
+    Controller_Remote() {}
+    virtual ~Controller_Remote() {}
+
+    void tick(float deltaTSec);
+
+    void queuePlacement(iEntityStats::MobType type, const Vec2& pos);
+
+    // The results of the placements made during the last tick, in the order
+    // they were queued.
+    const std::vector<iPlayer::PlacementResult>& getResults() const { return m_Results; }
+    void clearResults() { m_Results.clear(); }
+
+private:
+    struct Placement
+    {
+        iEntityStats::MobType m_Type;
+        Vec2 m_Pos;
+    };
+
+    std::vector<Placement> m_Queue;
+    std::vector<iPlayer::PlacementResult> m_Results;
+};
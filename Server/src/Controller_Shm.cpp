@@ -0,0 +1,288 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Controller_Shm.h"
+
+#include "EntityStats.h"
+#include "iPlayer.h"
+#include "ShmChannel.h"
+#include "Vec2.h"
+
+#include <chrono>
+#include <cmath>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+const float Controller_Shm::ksDefaultTimeoutSec = 0.05f;
+
+static int64_t nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+Controller_Shm::Controller_Shm(const std::string& hostPath, const std::string& controllerName, float timeoutSec)
+    : m_HostPath(hostPath)
+    , m_ControllerName(controllerName)
+    , m_TimeoutNs((int64_t)(timeoutSec * 1e9f))
+    , m_ShmFd(-1)
+    , m_pChannel(NULL)
+    , m_HostPid(-1)
+    , m_Tick(0)
+    , m_bTurnPending(false)
+    , m_PendingTick(0)
+    , m_PublishNs(0)
+    , m_UnsentDeltaTSec(0.f)
+{
+    memset(&m_Stats, 0, sizeof(m_Stats));
+
+    m_ShmFd = memfd_create("crashloyal-controller", MFD_CLOEXEC);
+    if ((m_ShmFd < 0) || (ftruncate(m_ShmFd, sizeof(Shm::Channel)) < 0))
+    {
+        std::cout << "Controller_Shm: couldn't create the shared memory (" << strerror(errno) << ")\n";
+        return;
+    }
+
+    void* pMem = mmap(NULL, sizeof(Shm::Channel), PROT_READ | PROT_WRITE, MAP_SHARED, m_ShmFd, 0);
+    if (pMem == MAP_FAILED)
+    {
+        std::cout << "Controller_Shm: couldn't map the shared memory (" << strerror(errno) << ")\n";
+        return;
+    }
+    m_pChannel = (Shm::Channel*)pMem;
+
+    startHost();
+}
+
+Controller_Shm::~Controller_Shm()
+{
+    stopHost();
+    if (m_pChannel)
+        munmap(m_pChannel, sizeof(Shm::Channel));
+    if (m_ShmFd >= 0)
+        close(m_ShmFd);
+}
+
+bool Controller_Shm::startHost()
+{
+    assert(m_HostPid < 0);
+    if (!m_pChannel)
+        return false;
+
+    // Start every host with a clean channel, so that nothing a dead one left
+    // behind gets applied.  The host waits for m_Published to move past 
+    // m_Done, which happens when we publish the next tick.
+    memset((void*)m_pChannel, 0, sizeof(Shm::Channel));
+    m_pChannel->m_Magic = Shm::kMagic;
+    m_pChannel->m_Published.store(m_Tick - 1, std::memory_order_relaxed);
+    m_pChannel->m_Done.store(m_Tick - 1, std::memory_order_relaxed);
+
+    // The host expects the channel on a fixed fd.  dup2 clears close-on-exec
+    // for the new fd (and nothing else we have open gets inherited).
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, m_ShmFd, Shm::kHostFd);
+
+    const char* args[] = { m_HostPath.c_str(), m_ControllerName.c_str(), NULL };
+    pid_t pid;
+    const int err = posix_spawn(&pid, m_HostPath.c_str(), &actions, NULL, (char* const*)args, environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (err != 0)
+    {
+        std::cout << "Controller_Shm: couldn't start " << m_HostPath << " (" << strerror(err) << ")\n";
+        return false;
+    }
+
+    m_HostPid = pid;
+    m_bTurnPending = false;
+    return true;
+}
+
+void Controller_Shm::stopHost()
+{
+    if (m_HostPid < 0)
+        return;
+
+    kill(m_HostPid, SIGKILL);
+    waitpid(m_HostPid, NULL, 0);
+    m_HostPid = -1;
+}
+
+bool Controller_Shm::isHostAlive()
+{
+    if (m_HostPid < 0)
+        return false;
+
+    int status;
+    if (waitpid(m_HostPid, &status, WNOHANG) == 0)
+        return true;
+
+    // It's gone (and now it's reaped).
+    m_HostPid = -1;
+    return false;
+}
+
+void Controller_Shm::tick(float deltaTSec)
+{
+    assert(m_pPlayer);
+
+    ++m_Tick;
+    ++m_Stats.m_NumTicks;
+    m_UnsentDeltaTSec += deltaTSec;
+
+    if (!isHostAlive())
+    {
+        if ((m_Stats.m_NumRestarts >= ksMaxRestarts) || !m_pChannel)
+            return;
+
+        ++m_Stats.m_NumRestarts;
+        std::cout << "Controller_Shm: restarting " << m_HostPath << " " << m_ControllerName << "\n";
+        if (!startHost())
+            return;
+    }
+
+    const int64_t now = nowNs();
+    if (m_bTurnPending)
+    {
+        if (isHostDone())
+        {
+            const uint64_t roundTripNs = (uint64_t)(now - m_PublishNs);
+            m_Stats.m_TotalRoundTripNs += roundTripNs;
+            m_Stats.m_MaxRoundTripNs = std::max(m_Stats.m_MaxRoundTripNs, roundTripNs);
+
+            applyCommands();
+            m_bTurnPending = false;
+        }
+        else if (now - m_PublishNs < m_TimeoutNs)
+        {
+            ++m_Stats.m_NumBusyTicks;
+            return;
+        }
+        else
+        {
+            // Give up on it.  The host skips straight to the latest state
+            // when it's done, and applyCommands() drops anything late.
+            ++m_Stats.m_NumTimeouts;
+            m_bTurnPending = false;
+        }
+    }
+
+    publishState(m_UnsentDeltaTSec);
+    m_UnsentDeltaTSec = 0.f;
+    m_bTurnPending = true;
+    m_PendingTick = m_Tick;
+    m_PublishNs = now;
+}
+
+static void fillList(Shm::WorldState& state, Shm::EntityList list, 
+                     unsigned int num, iPlayer::EntityData (iPlayer::*getFn)(unsigned int) const,
+                     const iPlayer& player, bool bBuildings)
+{
+    num = std::min(num, Shm::kMaxEntities);
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        const iPlayer::EntityData data = (player.*getFn)(i);
+        Shm::EntityRecord& rec = state.m_Entities[list][i];
+        rec.m_Type = bBuildings ? (int32_t)data.m_Stats.getBuildingType() : (int32_t)data.m_Stats.getMobType();
+        rec.m_Health = data.m_Health;
+        rec.m_X = (float)data.m_Position.x;
+        rec.m_Y = (float)data.m_Position.y;
+    }
+    state.m_Counts[list] = num;
+}
+
+void Controller_Shm::publishState(float deltaTSec)
+{
+    Shm::Channel& channel = *m_pChannel;
+    Shm::WorldState& state = channel.m_State;
+    const iPlayer& player = *m_pPlayer;
+
+    // Seqlock write: odd while we're in here.
+    const uint32_t seq = channel.m_StateSeq.load(std::memory_order_relaxed);
+    channel.m_StateSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    state.m_Tick = m_Tick;
+    state.m_DeltaTSec = deltaTSec;
+    state.m_Elixir = player.getElixir();
+    state.m_bNorth = player.isNorth() ? 1 : 0;
+    state.m_ArenaWidth = player.getLayout().getWidth();
+    state.m_ArenaHeight = player.getLayout().getHeight();
+    fillList(state, Shm::MyBuildings, player.getNumBuildings(), &iPlayer::getBuilding, player, true);
+    fillList(state, Shm::MyMobs, player.getNumMobs(), &iPlayer::getMob, player, false);
+    fillList(state, Shm::TheirBuildings, player.getNumOpponentBuildings(), &iPlayer::getOpponentBuilding, player, true);
+    fillList(state, Shm::TheirMobs, player.getNumOpponentMobs(), &iPlayer::getOpponentMob, player, false);
+
+    channel.m_StateSeq.store(seq + 2, std::memory_order_release);
+
+    channel.m_Published.store(m_Tick, std::memory_order_release);
+    Shm::futexWake(&channel.m_Published);
+}
+
+bool Controller_Shm::isHostDone() const
+{
+    return m_pChannel->m_Done.load(std::memory_order_acquire) == m_PendingTick;
+}
+
+void Controller_Shm::applyCommands()
+{
+    Shm::Channel& channel = *m_pChannel;
+    const uint32_t head = channel.m_CmdHead.load(std::memory_order_acquire);
+    uint32_t tail = channel.m_CmdTail.load(std::memory_order_relaxed);
+
+    // Don't trust the head - it came from another process.
+    if (head - tail > Shm::kCommandRingSize)
+        tail = head - Shm::kCommandRingSize;
+
+    for (; tail != head; ++tail)
+    {
+        const Shm::Command cmd = channel.m_Commands[tail & (Shm::kCommandRingSize - 1)];
+
+        // Commands from a turn that we gave up waiting on are too late.
+        if (cmd.m_Tick != m_PendingTick)
+            continue;
+        if ((cmd.m_MobType < 0) || (cmd.m_MobType >= iEntityStats::numMobTypes))
+            continue;
+
+        // Nor the position - Player::place() casts it to an int, which isn't
+        // safe for NaNs, infinities or anything huge.
+        const ArenaLayout& layout = m_pPlayer->getLayout();
+        if (!std::isfinite(cmd.m_X) || !std::isfinite(cmd.m_Y) ||
+            (cmd.m_X < 0.f) || (cmd.m_X > (float)layout.getWidth()) ||
+            (cmd.m_Y < 0.f) || (cmd.m_Y > (float)layout.getHeight()))
+        {
+            continue;
+        }
+
+        m_pPlayer->placeMob((iEntityStats::MobType)cmd.m_MobType, Vec2(cmd.m_X, cmd.m_Y));
+    }
+
+    channel.m_CmdTail.store(tail, std::memory_order_release);
+}
@@ -0,0 +1,98 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "iController.h"
+
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+namespace Shm { struct Channel; }
+
+// A controller that runs the real controller in a separate aihost process, so
+// that an AI which crashes or leaks can't take the game down with it.  The 
+// two processes talk through shared memory (see ShmChannel.h), which keeps
+// the round trip for each turn down to a few microseconds.
+//
+// We never wait on the host, since tick() runs on a worker that's shared 
+// with other matches.  Each tick we publish the state (if the host has 
+// finished its last turn), and the commands it sends back are placed at 
+// the start of our next tick.  While it's still thinking the game carries
+// on without it, the same as Controller_Async.  If it takes longer than the
+// timeout we give up on that turn (anything it sends for it is dropped) and 
+// publish a fresh one.  If it has died we start a new one (up to 
+// ksMaxRestarts times, after which we just stop placing mobs).
+// NOTE: This is Linux only.
+class Controller_Shm : public iController
+{
+public:
+    static const float ksDefaultTimeoutSec;
+    static const unsigned int ksMaxRestarts = 5;
+
+    // hostPath is the aihost executable, and controllerName tells it which
+    // controller to run (see AIHost.cpp).
+    Controller_Shm(const std::string& hostPath, const std::string& controllerName, 
+                   float timeoutSec = ksDefaultTimeoutSec);
+    virtual ~Controller_Shm();
+
+    void tick(float deltaTSec);
+
+    struct Stats
+    {
+        uint64_t m_NumTicks;
+        uint64_t m_NumBusyTicks;        // ticks where the host was still thinking
+        uint64_t m_NumTimeouts;
+        uint64_t m_NumRestarts;
+        uint64_t m_TotalRoundTripNs;    // publish to the tick we saw it was done
+        uint64_t m_MaxRoundTripNs;
+    };
+    const Stats& getStats() const { return m_Stats; }
+
+private:
+    bool startHost();
+    void stopHost();
+    bool isHostAlive();
+
+    void publishState(float deltaTSec);
+    bool isHostDone() const;
+    void applyCommands();
+
+private:
+    std::string m_HostPath;
+    std::string m_ControllerName;
+    int64_t m_TimeoutNs;
+
+    int m_ShmFd;
+    Shm::Channel* m_pChannel;       // mapped, shared with the host
+    pid_t m_HostPid;                // -1 if there's no host running
+    uint32_t m_Tick;
+
+    // The turn that the host is working on, if any.
+    bool m_bTurnPending;
+    uint32_t m_PendingTick;
+    int64_t m_PublishNs;
+    float m_UnsentDeltaTSec;    // game time since the last state we published
+
+    Stats m_Stats;
+};
@@ -0,0 +1,287 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A load tester for the MatchServer.  It opens lots of connections at once,
+// each of which plays a match (against the built-in AI, or against another
+// one of our connections) and answers every Tick immediately, dropping a
+// Swordsman at a bridge whenever it can afford one.  Usage:
+//    crashloyal_echobot [socket path] [-n numConnections] [-pair]
+
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Protocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono;
+
+struct BotConnection
+{
+    int m_Fd;
+    std::vector<uint8_t> m_In;
+    bool m_bNorth;
+    bool m_bDone;
+    unsigned int m_NumPlaced;
+    steady_clock::time_point m_TurnSent;
+    bool m_bWaiting;
+};
+
+static void raiseFdLimit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static bool sendAll(int fd, const std::vector<uint8_t>& data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) 
+        { 
+            sent += (size_t)n; 
+            continue; 
+        }
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+        {
+            // Our messages are tiny, so this basically never happens.
+            std::this_thread::yield();
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* args[])
+{
+    std::string socketPath = "/tmp/crashloyal.sock";
+    unsigned int numConnections = 100;
+    uint8_t opponent = Protocol::BuiltInAI;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(args[i], "-n") == 0) && (i + 1 < argc))
+            numConnections = (unsigned int)atoi(args[++i]);
+        else if (strcmp(args[i], "-pair") == 0)
+            opponent = Protocol::OtherClient;
+        else
+            socketPath = args[i];
+    }
+
+    raiseFdLimit();
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    const int epollFd = epoll_create1(0);
+    std::vector<BotConnection*> conns;
+
+    std::vector<uint8_t> msg;
+    Protocol::Writer writer(msg);
+
+    const steady_clock::time_point startTime = steady_clock::now();
+    for (unsigned int i = 0; i < numConnections; ++i)
+    {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        while (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            if (errno != EAGAIN)
+            {
+                perror("connect");
+                return 1;
+            }
+            // The server's backlog is full - give it a moment.
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+
+        msg.clear();
+        writer.beginMessage(Protocol::Hello);
+        writer.put8(Protocol::kVersion);
+        writer.put8(opponent);
+        writer.endMessage();
+        sendAll(fd, msg);
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        BotConnection* pConn = new BotConnection;
+        pConn->m_Fd = fd;
+        pConn->m_bNorth = false;
+        pConn->m_bDone = false;
+        pConn->m_NumPlaced = 0;
+        pConn->m_bWaiting = false;
+        conns.push_back(pConn);
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = pConn;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    unsigned int numDone = 0;
+    unsigned long long numTicks = 0;
+    int results[3] = { 0, 0, 0 };       // south won, draw, north won (from north's point of view)
+    std::vector<float> roundTripUs;
+    roundTripUs.reserve(1 << 20);
+
+    const int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    uint8_t buff[8192];
+
+    while (numDone < numConnections)
+    {
+        const int numEvents = epoll_wait(epollFd, events, kMaxEvents, 5000);
+        if (numEvents == 0)
+        {
+            printf("Timed out waiting for the server (%u of %u matches done)\n", numDone, numConnections);
+            break;
+        }
+
+        for (int e = 0; e < numEvents; ++e)
+        {
+            BotConnection& conn = *(BotConnection*)events[e].data.ptr;
+            if (conn.m_bDone)
+                continue;
+
+            bool bClosed = false;
+            while (true)
+            {
+                const ssize_t n = recv(conn.m_Fd, buff, sizeof(buff), 0);
+                if (n > 0) { conn.m_In.insert(conn.m_In.end(), buff, buff + n); continue; }
+                if ((n < 0) && (errno == EINTR)) continue;
+                if ((n < 0) && (errno == EAGAIN)) break;
+                bClosed = true;
+                break;
+            }
+
+            size_t offset = 0;
+            Protocol::MessageType type;
+            const uint8_t* pPayload;
+            size_t payloadLen;
+            while (size_t msgLen = Protocol::peekMessage(conn.m_In, offset, type, pPayload, payloadLen))
+            {
+                offset += msgLen;
+                Protocol::Reader reader(pPayload, payloadLen);
+
+                if (type == Protocol::MatchStart)
+                {
+                    reader.get32();
+                    conn.m_bNorth = (reader.get8() != 0);
+                }
+                else if (type == Protocol::Tick)
+                {
+                    if (conn.m_bWaiting)
+                    {
+                        roundTripUs.push_back(duration<float, std::micro>(steady_clock::now() - conn.m_TurnSent).count());
+                        conn.m_bWaiting = false;
+                    }
+
+                    const uint32_t tick = reader.get32();
+                    const float elixir = (float)reader.get16() / 100.f;
+                    ++numTicks;
+
+                    msg.clear();
+                    const iEntityStats& stats = iEntityStats::getStats(iEntityStats::Swordsman);
+                    if (elixir >= stats.getElixirCost())
+                    {
+                        // Alternate between the bridges, on our side of the river.
+                        const float x = (conn.m_NumPlaced++ % 2) ? RIGHT_BRIDGE_CENTER_X : LEFT_BRIDGE_CENTER_X;
+                        const float y = conn.m_bNorth ? (RIVER_TOP_Y - 1.5f) : (RIVER_BOT_Y + 1.5f);
+                        writer.beginMessage(Protocol::PlaceMob);
+                        writer.put8(iEntityStats::Swordsman);
+                        writer.put16(Protocol::toCm(x));
+                        writer.put16(Protocol::toCm(y));
+                        writer.endMessage();
+                    }
+
+                    writer.beginMessage(Protocol::EndTurn);
+                    writer.put32(tick);
+                    writer.endMessage();
+
+                    conn.m_TurnSent = steady_clock::now();
+                    conn.m_bWaiting = true;
+                    sendAll(conn.m_Fd, msg);
+                }
+                else if (type == Protocol::MatchEnd)
+                {
+                    const int winner = (int8_t)reader.get8();
+                    if (conn.m_bNorth || (opponent == Protocol::BuiltInAI))
+                    {
+                        results[winner + 1] += 1;
+                    }
+                    conn.m_bWaiting = false;
+                    bClosed = true;
+                }
+            }
+            conn.m_In.erase(conn.m_In.begin(), conn.m_In.begin() + offset);
+
+            if (bClosed)
+            {
+                conn.m_bDone = true;
+                ++numDone;
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.m_Fd, NULL);
+                close(conn.m_Fd);
+            }
+        }
+    }
+
+    const double secs = duration<double>(steady_clock::now() - startTime).count();
+    std::sort(roundTripUs.begin(), roundTripUs.end());
+    const size_t numRoundTrips = std::max((size_t)1, roundTripUs.size());
+    double totalUs = 0.;
+    for (float us : roundTripUs) totalUs += us;
+
+    printf("%u connections, %u matches done in %.2f sec\n", numConnections, numDone, secs);
+    printf("  results (north won / draw / south won): %d / %d / %d\n", results[2], results[1], results[0]);
+    printf("  %.0f ticks/sec received\n", (double)numTicks / secs);
+    if (!roundTripUs.empty())
+    {
+        printf("  turn round trip: avg %.1f us, p50 %.1f us, p99 %.1f us\n",
+               totalUs / (double)numRoundTrips,
+               roundTripUs[roundTripUs.size() / 2],
+               roundTripUs[(roundTripUs.size() * 99) / 100]);
+    }
+
+    for (BotConnection* pConn : conns) delete pConn;
+    close(epollFd);
+    return (numDone == numConnections) ? 0 : 1;
+}
@@ -0,0 +1,959 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MatchServer.h"
+
+#include "Building.h"
+#include "Constants.h"
+#include "Controller_AI_KevinDill.h"
+#include "Controller_Remote.h"
+#include "Controller_Shm.h"
+#include "Game.h"
+#include "Mob.h"
+#include "Player.h"
+#include "Protocol.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+// Matches that haven't been won after this long (in game time) are a draw.
+static const uint32_t ksMaxMatchTicks = (uint32_t)(180.f / TICK_MIN);
+
+// Every tick is the same length, so that matches are reproducible.
+static const float ksTickSec = TICK_MIN;
+
+// Clients send their Hello as soon as they connect, so give up on any that
+// haven't after this long.
+static const std::chrono::milliseconds ksHelloTimeout(1000);
+
+namespace
+{
+    struct Match;
+
+    struct Connection
+    {
+        int m_Fd;
+        std::vector<uint8_t> m_In;
+        std::vector<uint8_t> m_Out;
+        size_t m_OutPos;
+        bool m_bWantWrite;          // registered for EPOLLOUT
+        bool m_bCloseAfterFlush;
+        bool m_bClosed;
+
+        Match* m_pMatch;            // NOT owned, NULL once the match is over
+        int m_Seat;                 // 0 => north, 1 => south
+    };
+
+    struct EntityState
+    {
+        uint8_t m_Kind;
+        uint16_t m_X;
+        uint16_t m_Y;
+        int32_t m_Health;
+        uint32_t m_SeenTick;
+    };
+
+    struct Match
+    {
+        uint32_t m_Id;
+        Game* m_pGame;                          // owned
+        Controller_Remote* m_pControllers[2];   // owned by the game, NULL for the built-in AI
+        Connection* m_pConns[2];                // NOT owned, NULL for the AI or once disconnected
+        bool m_bTurnDone[2];
+        uint32_t m_Tick;
+
+        // What we've told the clients so far, so that we only send changes.
+        std::unordered_map<uint32_t, EntityState> m_LastSent;
+    };
+}
+
+class MatchServer::Worker
+{
+public:
+    // If aiHostPath isn't empty then the built-in AI runs in its own aihost
+    // process (see Controller_Shm).
+    Worker(std::atomic<bool>& bQuit, const std::string& aiHostPath, const ControllerBudget::Settings& budget);
+    ~Worker();
+
+    // Called from the accept thread.  southFd may be -1, in which case the
+    // south player is the built-in AI.
+    void post(uint32_t matchId, int northFd, int southFd);
+
+    void getStats(MatchServer::Stats& stats) const;
+
+private:
+    struct NewMatch
+    {
+        uint32_t m_Id;
+        int m_Fds[2];
+    };
+
+    void run();
+    void startMatch(const NewMatch& newMatch);
+    void endMatch(Match& match, int winner);
+
+    void onReadable(Connection& conn);
+    void onMessage(Connection& conn, Protocol::MessageType type, Protocol::Reader& reader);
+    void disconnect(Connection& conn);
+
+    void tryStep(Match& match);
+    void sendTick(Match& match);
+    void buildDelta(Match& match);
+
+    void send(Connection& conn, const std::vector<uint8_t>& data);
+    void flush(Connection& conn);
+    void close(Connection& conn);
+
+private:
+    std::atomic<bool>& m_bQuit;
+    std::string m_AIHostPath;
+    ControllerBudget::Settings m_Budget;
+    int m_EpollFd;
+    int m_WakeFd;
+    std::thread m_Thread;
+
+    std::mutex m_InboxLock;
+    std::vector<NewMatch> m_Inbox;
+
+    std::unordered_set<Match*> m_Matches;   // owned
+
+    // Connections aren't deleted until the end of a batch of events, since
+    // there may still be events for them in the batch.
+    std::vector<Connection*> m_Graveyard;
+
+    // Scratch buffers, kept around so that we don't allocate every tick.
+    std::vector<uint8_t> m_Delta;
+    uint16_t m_NumChanged;
+    std::vector<uint32_t> m_Removed;
+    std::vector<uint8_t> m_Msg;
+
+    std::atomic<uint64_t> m_MatchesStarted;
+    std::atomic<uint64_t> m_MatchesFinished;
+    std::atomic<uint64_t> m_TicksSimulated;
+    std::atomic<uint64_t> m_BytesSent;
+};
+
+MatchServer::Worker::Worker(std::atomic<bool>& bQuit, const std::string& aiHostPath, const ControllerBudget::Settings& budget)
+    : m_bQuit(bQuit)
+    , m_AIHostPath(aiHostPath)
+    , m_Budget(budget)
+    , m_EpollFd(epoll_create1(0))
+    , m_WakeFd(eventfd(0, EFD_NONBLOCK))
+    , m_NumChanged(0)
+    , m_MatchesStarted(0)
+    , m_MatchesFinished(0)
+    , m_TicksSimulated(0)
+    , m_BytesSent(0)
+{
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;     // NULL => the wake up fd
+    epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, m_WakeFd, &ev);
+
+    m_Thread = std::thread(&Worker::run, this);
+}
+
+MatchServer::Worker::~Worker()
+{
+    // m_bQuit has already been set - just make sure we notice.
+    uint64_t one = 1;
+    ssize_t unused = write(m_WakeFd, &one, sizeof(one));
+    (void)unused;
+    m_Thread.join();
+
+    for (Match* pMatch : m_Matches)
+    {
+        for (Connection* pConn : pMatch->m_pConns)
+        {
+            if (pConn)
+            {
+                ::close(pConn->m_Fd);
+                delete pConn;
+            }
+        }
+        delete pMatch->m_pGame;
+        delete pMatch;
+    }
+    for (Connection* pConn : m_Graveyard) delete pConn;
+
+    ::close(m_WakeFd);
+    ::close(m_EpollFd);
+}
+
+void MatchServer::Worker::post(uint32_t matchId, int northFd, int southFd)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_InboxLock);
+        NewMatch newMatch = { matchId, { northFd, southFd } };
+        m_Inbox.push_back(newMatch);
+    }
+
+    uint64_t one = 1;
+    ssize_t unused = write(m_WakeFd, &one, sizeof(one));
+    (void)unused;
+}
+
+void MatchServer::Worker::getStats(MatchServer::Stats& stats) const
+{
+    stats.m_MatchesStarted += m_MatchesStarted;
+    stats.m_MatchesFinished += m_MatchesFinished;
+    stats.m_TicksSimulated += m_TicksSimulated;
+    stats.m_BytesSent += m_BytesSent;
+}
+
+void MatchServer::Worker::run()
+{
+    const int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    std::vector<NewMatch> newMatches;
+
+    while (!m_bQuit)
+    {
+        const int numEvents = epoll_wait(m_EpollFd, events, kMaxEvents, 1000);
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            Connection* pConn = (Connection*)events[i].data.ptr;
+            if (!pConn)
+            {
+                uint64_t count;
+                ssize_t unused = read(m_WakeFd, &count, sizeof(count));
+                (void)unused;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_InboxLock);
+                    newMatches.swap(m_Inbox);
+                }
+                for (const NewMatch& newMatch : newMatches)
+                {
+                    startMatch(newMatch);
+                }
+                newMatches.clear();
+                continue;
+            }
+
+            if (pConn->m_bClosed)
+                continue;
+
+            if (events[i].events & EPOLLOUT)
+            {
+                flush(*pConn);
+            }
+
+            if (!pConn->m_bClosed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+            {
+                onReadable(*pConn);
+            }
+        }
+
+        for (Connection* pConn : m_Graveyard) delete pConn;
+        m_Graveyard.clear();
+    }
+}
+
+void MatchServer::Worker::startMatch(const NewMatch& newMatch)
+{
+    Match* pMatch = new Match;
+    pMatch->m_Id = newMatch.m_Id;
+    pMatch->m_Tick = 0;
+
+    iController* pControllers[2];
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        Connection* pConn = NULL;
+        if (newMatch.m_Fds[seat] >= 0)
+        {
+            pConn = new Connection;
+            pConn->m_Fd = newMatch.m_Fds[seat];
+            pConn->m_OutPos = 0;
+            pConn->m_bWantWrite = false;
+            pConn->m_bCloseAfterFlush = false;
+            pConn->m_bClosed = false;
+            pConn->m_pMatch = pMatch;
+            pConn->m_Seat = seat;
+
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.ptr = pConn;
+            epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, pConn->m_Fd, &ev);
+
+            pMatch->m_pControllers[seat] = new Controller_Remote;
+            pControllers[seat] = pMatch->m_pControllers[seat];
+        }
+        else
+        {
+            pMatch->m_pControllers[seat] = NULL;
+            if (m_AIHostPath.empty())
+                pControllers[seat] = new Controller_AI_KevinDill;
+            else
+                pControllers[seat] = new Controller_Shm(m_AIHostPath, "KevinDill");
+        }
+
+        pMatch->m_pConns[seat] = pConn;
+        pMatch->m_bTurnDone[seat] = (pConn == NULL);
+    }
+
+    // Lots of matches share each worker, so each game only gets one thread.
+    pMatch->m_pGame = new Game(pControllers[0], pControllers[1], 1);
+    pMatch->m_pGame->setLogging(false);
+    pMatch->m_pGame->setControllerBudget(m_Budget);
+    m_Matches.insert(pMatch);
+    ++m_MatchesStarted;
+
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        if (pMatch->m_pConns[seat])
+        {
+            m_Msg.clear();
+            Protocol::Writer writer(m_Msg);
+            writer.beginMessage(Protocol::MatchStart);
+            writer.put32(pMatch->m_Id);
+            writer.put8(seat == 0 ? 1 : 0);
+            writer.endMessage();
+            send(*pMatch->m_pConns[seat], m_Msg);
+        }
+    }
+
+    sendTick(*pMatch);
+}
+
+void MatchServer::Worker::endMatch(Match& match, int winner)
+{
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        Connection* pConn = match.m_pConns[seat];
+        if (!pConn)
+            continue;
+
+        m_Msg.clear();
+        Protocol::Writer writer(m_Msg);
+        writer.beginMessage(Protocol::MatchEnd);
+        writer.put8((uint8_t)(int8_t)winner);
+        writer.put32(match.m_Tick);
+        writer.endMessage();
+        send(*pConn, m_Msg);
+
+        pConn->m_pMatch = NULL;
+        pConn->m_bCloseAfterFlush = true;
+        flush(*pConn);
+    }
+
+    m_Matches.erase(&match);
+    delete match.m_pGame;
+    delete &match;
+    ++m_MatchesFinished;
+}
+
+void MatchServer::Worker::onReadable(Connection& conn)
+{
+    uint8_t buff[4096];
+    while (true)
+    {
+        const ssize_t n = recv(conn.m_Fd, buff, sizeof(buff), 0);
+        if (n > 0)
+        {
+            conn.m_In.insert(conn.m_In.end(), buff, buff + n);
+            continue;
+        }
+
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+            break;
+        if ((n < 0) && (errno == EINTR))
+            continue;
+
+        // EOF or a real error
+        disconnect(conn);
+        return;
+    }
+
+    size_t offset = 0;
+    Protocol::MessageType type;
+    const uint8_t* pPayload;
+    size_t payloadLen;
+    while (size_t msgLen = Protocol::peekMessage(conn.m_In, offset, type, pPayload, payloadLen))
+    {
+        Protocol::Reader reader(pPayload, payloadLen);
+        onMessage(conn, type, reader);
+        offset += msgLen;
+
+        // The message may have finished the match, and with it this connection.
+        if (conn.m_bClosed || !conn.m_pMatch)
+            break;
+    }
+    conn.m_In.erase(conn.m_In.begin(), conn.m_In.begin() + std::min(offset, conn.m_In.size()));
+}
+
+void MatchServer::Worker::onMessage(Connection& conn, Protocol::MessageType type, Protocol::Reader& reader)
+{
+    Match* pMatch = conn.m_pMatch;
+    if (!pMatch)
+        return;
+
+    const int seat = conn.m_Seat;
+    switch (type)
+    {
+    case Protocol::PlaceMob:
+    {
+        const uint8_t mobType = reader.get8();
+        const float x = Protocol::fromCm(reader.get16());
+        const float y = Protocol::fromCm(reader.get16());
+        if (!reader.isBad() && !pMatch->m_bTurnDone[seat])
+        {
+            pMatch->m_pControllers[seat]->queuePlacement((iEntityStats::MobType)mobType, Vec2(x, y));
+        }
+        break;
+    }
+
+    case Protocol::EndTurn:
+    {
+        // Ignore stale (or bogus) turns.
+        const uint32_t tick = reader.get32();
+        if (!reader.isBad() && (tick == pMatch->m_Tick))
+        {
+            pMatch->m_bTurnDone[seat] = true;
+            tryStep(*pMatch);
+        }
+        break;
+    }
+
+    default:
+        // Unknown messages are ignored, so that clients can be newer than us.
+        break;
+    }
+}
+
+void MatchServer::Worker::disconnect(Connection& conn)
+{
+    Match* pMatch = conn.m_pMatch;
+    close(conn);
+    if (!pMatch)
+        return;
+
+    // Whoever's left keeps playing against a controller that does nothing.
+    pMatch->m_pConns[conn.m_Seat] = NULL;
+    pMatch->m_bTurnDone[conn.m_Seat] = true;
+
+    if (!pMatch->m_pConns[0] && !pMatch->m_pConns[1])
+    {
+        // Nobody is watching - just throw the match away.
+        m_Matches.erase(pMatch);
+        delete pMatch->m_pGame;
+        delete pMatch;
+        ++m_MatchesFinished;
+        return;
+    }
+
+    tryStep(*pMatch);
+}
+
+void MatchServer::Worker::tryStep(Match& match)
+{
+    if (!match.m_bTurnDone[0] || !match.m_bTurnDone[1])
+        return;
+
+    match.m_pGame->tick(ksTickSec);
+    ++match.m_Tick;
+    ++m_TicksSimulated;
+
+    const int winner = match.m_pGame->checkGameOver();
+    if ((winner != 0) || (match.m_Tick >= ksMaxMatchTicks))
+    {
+        endMatch(match, winner);
+        return;
+    }
+
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        match.m_bTurnDone[seat] = (match.m_pConns[seat] == NULL);
+    }
+
+    sendTick(match);
+}
+
+void MatchServer::Worker::buildDelta(Match& match)
+{
+    m_Delta.clear();
+    m_Removed.clear();
+    m_NumChanged = 0;
+
+    Protocol::Writer writer(m_Delta);
+
+    // Leave room for everything else in the message.  If we run out of 
+    // room, the rest will go out next tick.
+    const size_t kMaxRemoved = 128;
+    const size_t kMaxDelta = Protocol::kMaxPayload - 512 - (kMaxRemoved * 4);
+    const size_t kEntitySize = 15;
+
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        const Player& player = match.m_pGame->getPlayer(seat == 0);
+        const uint8_t northBit = (seat == 0) ? Protocol::kNorthKind : 0;
+
+        for (int list = 0; list < 2; ++list)
+        {
+            const bool bBuildings = (list == 0);
+            const std::vector<Entity*>& entities = bBuildings ? player.getBuildings() : player.getMobs();
+
+            for (const Entity* pEntity : entities)
+            {
+                const iEntityStats& stats = pEntity->getStats();
+                EntityState state;
+                state.m_Kind = northBit | (bBuildings 
+                    ? (uint8_t)(Protocol::kBuildingKind + stats.getBuildingType())
+                    : (uint8_t)stats.getMobType());
+                state.m_X = Protocol::toCm((float)pEntity->getPosition().x);
+                state.m_Y = Protocol::toCm((float)pEntity->getPosition().y);
+                state.m_Health = pEntity->getHealth();
+                state.m_SeenTick = match.m_Tick;
+
+                std::unordered_map<uint32_t, EntityState>::iterator it = match.m_LastSent.find(pEntity->getId());
+                const bool bChanged = (it == match.m_LastSent.end()) 
+                    || (it->second.m_X != state.m_X)
+                    || (it->second.m_Y != state.m_Y)
+                    || (it->second.m_Health != state.m_Health);
+
+                // If the delta is full then whatever's left will go out next
+                // tick (since we won't have recorded it as sent).
+                if (bChanged && (m_Delta.size() + kEntitySize <= kMaxDelta))
+                {
+                    writer.put32(pEntity->getId());
+                    writer.put8(state.m_Kind);
+                    writer.put16(state.m_X);
+                    writer.put16(state.m_Y);
+                    writer.put32((uint32_t)state.m_Health);
+                    ++m_NumChanged;
+
+                    match.m_LastSent[pEntity->getId()] = state;
+                }
+                else if (it != match.m_LastSent.end())
+                {
+                    it->second.m_SeenTick = match.m_Tick;
+                }
+            }
+        }
+    }
+
+    // Anything that we didn't see this tick has died.
+    for (std::unordered_map<uint32_t, EntityState>::iterator it = match.m_LastSent.begin(); it != match.m_LastSent.end();)
+    {
+        if ((it->second.m_SeenTick != match.m_Tick) && (m_Removed.size() < kMaxRemoved))
+        {
+            m_Removed.push_back(it->first);
+            it = match.m_LastSent.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void MatchServer::Worker::sendTick(Match& match)
+{
+    buildDelta(match);
+
+    for (int seat = 0; seat < 2; ++seat)
+    {
+        Connection* pConn = match.m_pConns[seat];
+        if (!pConn)
+            continue;
+
+        Controller_Remote* pControl = match.m_pControllers[seat];
+        const Player& player = match.m_pGame->getPlayer(seat == 0);
+
+        m_Msg.clear();
+        Protocol::Writer writer(m_Msg);
+        writer.beginMessage(Protocol::Tick);
+        writer.put32(match.m_Tick);
+        writer.put16((uint16_t)(player.getElixir() * 100.f));
+
+        const std::vector<iPlayer::PlacementResult>& results = pControl->getResults();
+        const size_t numResults = std::min(results.size(), (size_t)256);
+        writer.put16((uint16_t)numResults);
+        for (size_t i = 0; i < numResults; ++i)
+        {
+            writer.put8((uint8_t)results[i]);
+        }
+        pControl->clearResults();
+
+        writer.put16(m_NumChanged);
+        m_Msg.insert(m_Msg.end(), m_Delta.begin(), m_Delta.end());
+
+        writer.put16((uint16_t)m_Removed.size());
+        for (uint32_t id : m_Removed)
+        {
+            writer.put32(id);
+        }
+        writer.endMessage();
+
+        send(*pConn, m_Msg);
+    }
+}
+
+void MatchServer::Worker::send(Connection& conn, const std::vector<uint8_t>& data)
+{
+    if (conn.m_bClosed)
+        return;
+
+    conn.m_Out.insert(conn.m_Out.end(), data.begin(), data.end());
+    if (!conn.m_bWantWrite)
+    {
+        flush(conn);
+    }
+}
+
+void MatchServer::Worker::flush(Connection& conn)
+{
+    while (conn.m_OutPos < conn.m_Out.size())
+    {
+        const ssize_t n = ::send(conn.m_Fd, conn.m_Out.data() + conn.m_OutPos,
+                                 conn.m_Out.size() - conn.m_OutPos, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            conn.m_OutPos += (size_t)n;
+            m_BytesSent += (uint64_t)n;
+            continue;
+        }
+
+        if ((n < 0) && (errno == EINTR))
+            continue;
+
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+        {
+            // Wait until the socket drains
+            if (!conn.m_bWantWrite)
+            {
+                epoll_event ev = {};
+                ev.events = EPOLLIN | EPOLLOUT;
+                ev.data.ptr = &conn;
+                epoll_ctl(m_EpollFd, EPOLL_CTL_MOD, conn.m_Fd, &ev);
+                conn.m_bWantWrite = true;
+            }
+            return;
+        }
+
+        // The peer went away - we'll find out properly when we read.
+        conn.m_Out.clear();
+        conn.m_OutPos = 0;
+        if (conn.m_bCloseAfterFlush)
+        {
+            close(conn);
+        }
+        return;
+    }
+
+    conn.m_Out.clear();
+    conn.m_OutPos = 0;
+
+    if (conn.m_bCloseAfterFlush)
+    {
+        close(conn);
+        return;
+    }
+
+    if (conn.m_bWantWrite)
+    {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &conn;
+        epoll_ctl(m_EpollFd, EPOLL_CTL_MOD, conn.m_Fd, &ev);
+        conn.m_bWantWrite = false;
+    }
+}
+
+void MatchServer::Worker::close(Connection& conn)
+{
+    if (conn.m_bClosed)
+        return;
+
+    epoll_ctl(m_EpollFd, EPOLL_CTL_DEL, conn.m_Fd, NULL);
+    ::close(conn.m_Fd);
+    conn.m_bClosed = true;
+    m_Graveyard.push_back(&conn);
+}
+
+MatchServer::MatchServer(const std::string& socketPath, unsigned int numWorkers)
+    : m_SocketPath(socketPath)
+    , m_ListenFd(-1)
+    , m_bQuit(false)
+    , m_NextWorker(0)
+    , m_NextMatchId(1)
+    , m_WaitingFd(-1)
+{
+    for (unsigned int i = 0; i < std::max(1u, numWorkers); ++i)
+    {
+        m_Workers.push_back(NULL);
+    }
+}
+
+MatchServer::~MatchServer()
+{
+    m_bQuit = true;
+    for (Worker* pWorker : m_Workers) delete pWorker;
+
+    for (const PendingHello& pending : m_PendingHellos) ::close(pending.m_Fd);
+    if (m_WaitingFd >= 0) ::close(m_WaitingFd);
+    if (m_ListenFd >= 0)
+    {
+        ::close(m_ListenFd);
+        unlink(m_SocketPath.c_str());
+    }
+}
+
+bool MatchServer::start()
+{
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (m_SocketPath.size() >= sizeof(addr.sun_path))
+    {
+        printf("Socket path is too long: %s\n", m_SocketPath.c_str());
+        return false;
+    }
+    strncpy(addr.sun_path, m_SocketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_ListenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_ListenFd < 0)
+    {
+        perror("socket");
+        return false;
+    }
+
+    unlink(m_SocketPath.c_str());
+    if ((bind(m_ListenFd, (sockaddr*)&addr, sizeof(addr)) < 0) || (listen(m_ListenFd, SOMAXCONN) < 0))
+    {
+        perror("bind/listen");
+        return false;
+    }
+
+    for (Worker*& pWorker : m_Workers)
+    {
+        pWorker = new Worker(m_bQuit, m_AIHostPath, m_Budget);
+    }
+
+    return true;
+}
+
+void MatchServer::run()
+{
+    using namespace std::chrono;
+
+    // Nothing on this thread may block on a client, including accept() (a
+    // client can hang up between poll() and accept()).
+    fcntl(m_ListenFd, F_SETFL, fcntl(m_ListenFd, F_GETFL, 0) | O_NONBLOCK);
+
+    std::vector<pollfd> fds;
+    while (!m_bQuit)
+    {
+        // The listening socket, then the waiting client (poll() skips it if 
+        // it's -1), then everybody we still need a Hello from.
+        fds.clear();
+        fds.push_back({ m_ListenFd, POLLIN, 0 });
+        fds.push_back({ m_WaitingFd, POLLRDHUP, 0 });
+        int timeoutMs = -1;
+        const steady_clock::time_point now = steady_clock::now();
+        for (const PendingHello& pending : m_PendingHellos)
+        {
+            fds.push_back({ pending.m_Fd, POLLIN, 0 });
+
+            const int untilDeadlineMs = (int)std::max<int64_t>(0, 
+                duration_cast<milliseconds>(pending.m_Deadline - now).count() + 1);
+            if ((timeoutMs < 0) || (untilDeadlineMs < timeoutMs))
+                timeoutMs = untilDeadlineMs;
+        }
+
+        if (poll(fds.data(), fds.size(), timeoutMs) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            break;
+        }
+        if (m_bQuit)
+            break;
+
+        // The waiting client isn't supposed to send anything until it has 
+        // a match, so this means that it hung up.
+        if ((m_WaitingFd >= 0) && (fds[1].revents != 0))
+        {
+            ::close(m_WaitingFd);
+            m_WaitingFd = -1;
+        }
+
+        // Backwards, so that removing one doesn't skip the next.
+        const steady_clock::time_point afterPoll = steady_clock::now();
+        for (size_t i = m_PendingHellos.size(); i-- > 0; )
+        {
+            PendingHello& pending = m_PendingHellos[i];
+            bool bKeep = true;
+            bool bDone = false;
+            uint8_t opponent = 0;
+            if (fds[2 + i].revents != 0)
+                bKeep = readHello(pending, bDone, opponent);
+            if (bKeep && !bDone && (afterPoll >= pending.m_Deadline))
+                bKeep = false;
+            if (bKeep && !bDone)
+                continue;
+
+            const int fd = pending.m_Fd;
+            m_PendingHellos[i] = m_PendingHellos.back();
+            m_PendingHellos.pop_back();
+
+            if (bKeep)
+                addClient(fd, opponent);
+            else
+                ::close(fd);
+        }
+
+        if (fds[0].revents != 0)
+            acceptAll();
+    }
+}
+
+void MatchServer::acceptAll()
+{
+    while (true)
+    {
+        const int fd = accept(m_ListenFd, NULL, NULL);
+        if (fd < 0)
+        {
+            if ((errno == EINTR) || (errno == ECONNABORTED))
+                continue;
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && !m_bQuit)
+            {
+                perror("accept");
+                stop();
+            }
+            return;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        PendingHello pending = {};
+        pending.m_Fd = fd;
+        pending.m_Got = 0;
+        pending.m_Deadline = std::chrono::steady_clock::now() + ksHelloTimeout;
+        m_PendingHellos.push_back(pending);
+    }
+}
+
+void MatchServer::addClient(int fd, uint8_t opponent)
+{
+    int northFd = fd;
+    int southFd = -1;
+    if (opponent == Protocol::OtherClient)
+    {
+        // poll() normally catches a waiting client hanging up, but it may 
+        // have done so since.
+        if ((m_WaitingFd >= 0) && !isWaitingClientAlive())
+        {
+            ::close(m_WaitingFd);
+            m_WaitingFd = -1;
+        }
+
+        if (m_WaitingFd < 0)
+        {
+            m_WaitingFd = fd;
+            return;
+        }
+
+        // Whoever was waiting longest gets to be north.
+        northFd = m_WaitingFd;
+        southFd = fd;
+        m_WaitingFd = -1;
+    }
+
+    m_Workers[m_NextWorker]->post(m_NextMatchId++, northFd, southFd);
+    m_NextWorker = (m_NextWorker + 1) % m_Workers.size();
+}
+
+bool MatchServer::isWaitingClientAlive() const
+{
+    uint8_t byte;
+    const ssize_t n = recv(m_WaitingFd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n >= 0)
+        return n > 0;
+    return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+}
+
+void MatchServer::stop()
+{
+    m_bQuit = true;
+    if (m_ListenFd >= 0)
+    {
+        // Wakes up accept()
+        shutdown(m_ListenFd, SHUT_RDWR);
+    }
+}
+
+MatchServer::Stats MatchServer::getStats() const
+{
+    Stats stats = {};
+    for (const Worker* pWorker : m_Workers)
+    {
+        if (pWorker)
+            pWorker->getStats(stats);
+    }
+    stats.m_MatchesActive = stats.m_MatchesStarted - stats.m_MatchesFinished;
+    return stats;
+}
+
+bool MatchServer::readHello(PendingHello& pending, bool& bDone, uint8_t& opponent)
+{
+    bDone = false;
+    while (pending.m_Got < sizeof(pending.m_Msg))
+    {
+        const ssize_t n = recv(pending.m_Fd, pending.m_Msg + pending.m_Got, sizeof(pending.m_Msg) - pending.m_Got, 0);
+        if (n <= 0)
+        {
+            if ((n < 0) && (errno == EINTR))
+                continue;
+            if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+                return true;
+            return false;
+        }
+        pending.m_Got += (size_t)n;
+    }
+
+    const uint8_t* msg = pending.m_Msg;
+    const size_t payloadLen = (size_t)msg[0] | ((size_t)msg[1] << 8);
+    if ((payloadLen != 2) || (msg[2] != Protocol::Hello) || (msg[3] != Protocol::kVersion))
+    {
+        printf("Rejecting a client with a bad Hello\n");
+        return false;
+    }
+
+    opponent = msg[4];
+    bDone = true;
+    return (opponent == Protocol::BuiltInAI) || (opponent == Protocol::OtherClient);
+}
@@ -0,0 +1,126 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// A headless server that hosts lots of matches at once, so that controllers
+// written by other teams can play on our ladder without being linked into
+// the game.  Controllers connect over a Unix domain socket and speak the 
+// protocol in Protocol.h.  
+//
+// The main thread accepts connections, reads each one's Hello and pairs 
+// them up into matches.  It never blocks on any one client, so a client that
+// connects and then says nothing can't hold up everybody else.  Each match 
+// is then handed to one of a small, fixed pool of worker threads, which 
+// owns it (and its connections) from then on and drives it with epoll, so 
+// no match ever needs a lock.
+// NOTE: This is Linux only (it uses epoll and eventfd).
+
+#include "ControllerBudget.h"
+#include "Protocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class MatchServer
+{
+public:
+    MatchServer(const std::string& socketPath, unsigned int numWorkers);
+    ~MatchServer();
+
+    // Run the built-in AI in its own process (see Controller_Shm), using the
+    // aihost at this path.  Call before start().
+    void setAIHost(const std::string& path) { m_AIHostPath = path; }
+
+    // Time limits for the controllers in every match (see ControllerBudget).
+    // A remote client's thinking happens between our ticks, so this only
+    // really limits the built-in AI.  Call before start().
+    void setControllerBudget(const ControllerBudget::Settings& budget) { m_Budget = budget; }
+
+    // Bind the socket and start the workers.  Returns false (after printing
+    // why) on failure.
+    bool start();
+
+    // Accept connections until stop() is called.
+    void run();
+
+    // Safe to call from any thread (or a signal handler).
+    void stop();
+
+    struct Stats
+    {
+        uint64_t m_MatchesStarted;
+        uint64_t m_MatchesFinished;
+        uint64_t m_MatchesActive;
+        uint64_t m_TicksSimulated;
+        uint64_t m_BytesSent;
+    };
+    Stats getStats() const;
+
+private:
+    class Worker;
+
+    // A client that has connected but hasn't sent all of its Hello yet.
+    struct PendingHello
+    {
+        int m_Fd;
+        uint8_t m_Msg[Protocol::kHeaderSize + 2];
+        size_t m_Got;
+        std::chrono::steady_clock::time_point m_Deadline;
+    };
+
+    void acceptAll();
+
+    // Reads whatever has arrived of the Hello.  Returns false if the client
+    // should be dropped, otherwise sets bDone once the whole thing is in.
+    bool readHello(PendingHello& pending, bool& bDone, uint8_t& opponent);
+
+    void addClient(int fd, uint8_t opponent);
+
+    // False if m_WaitingFd has hung up while it was waiting for an opponent.
+    bool isWaitingClientAlive() const;
+
+private:
+    std::string m_SocketPath;
+    std::string m_AIHostPath;
+    ControllerBudget::Settings m_Budget;
+    int m_ListenFd;
+    std::atomic<bool> m_bQuit;
+
+    std::vector<Worker*> m_Workers;     // owned
+    unsigned int m_NextWorker;
+    unsigned int m_NextMatchId;
+
+    std::vector<PendingHello> m_PendingHellos;
+
+    // A client that asked for another client as its opponent, and is waiting
+    // for one to show up.  -1 if there isn't one.
+    int m_WaitingFd;
+
+private:
+    // DELIBERATELY UNDEFINED
+    MatchServer(const MatchServer& rhs);
+    MatchServer& operator=(const MatchServer& rhs);
+};
@@ -0,0 +1,169 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// The wire protocol between the MatchServer and remote controllers.  
+//
+// Everything is little endian.  Each message is framed as:
+//    u16 payload length (not counting this 3 byte header)
+//    u8  message type
+//    ... payload
+//
+// Client -> Server
+//    Hello      u8 version, u8 opponent (see Opponent)
+//    PlaceMob   u8 mob type, u16 x, u16 y    (game coordinates, in cm)
+//    EndTurn    u32 tick                     (the tick we're responding to)
+//
+// Server -> Client
+//    MatchStart u32 match id, u8 isNorth
+//    Tick       u32 tick, u16 elixir (hundredths), 
+//               u16 numResults, numResults * u8 placement result (for the
+//                   PlaceMobs in our previous turn, in order),
+//               u16 numChanged, numChanged * EntityDelta,
+//               u16 numRemoved, numRemoved * u32 entity id
+//    MatchEnd   i8 winner (+1 north, -1 south, 0 draw), u32 ticks played
+//
+// EntityDelta is u32 id, u8 kind, u16 x, u16 y (cm), i32 health.  Kind is 
+// the MobType, or kBuildingKind + the BuildingType, with kNorthKind set for
+// the north player's entities.
+//
+// The server runs the match in lock step: it sends a Tick, waits for an 
+// EndTurn from every connected controller, applies any PlaceMobs and then 
+// simulates one tick.  The first Tick (tick 0) has the full state, the rest
+// only have what changed.
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace Protocol
+{
+    const uint8_t kVersion = 1;
+    const size_t kHeaderSize = 3;
+    const size_t kMaxPayload = 0xFFFF;
+
+    enum MessageType
+    {
+        Hello = 1,
+        PlaceMob,
+        EndTurn,
+
+        MatchStart = 10,
+        Tick,
+        MatchEnd,
+    };
+
+    enum Opponent
+    {
+        BuiltInAI = 0,
+        OtherClient,
+    };
+
+    const uint8_t kBuildingKind = 0x40;
+    const uint8_t kNorthKind = 0x80;
+
+    // Appends little endian values to a buffer.  beginMessage() and 
+    // endMessage() take care of the framing.
+    class Writer
+    {
+    public:
+        explicit Writer(std::vector<uint8_t>& buff) : m_Buff(buff), m_MsgStart(0) {}
+
+        void beginMessage(MessageType type)
+        {
+            m_MsgStart = m_Buff.size();
+            put16(0);
+            put8((uint8_t)type);
+        }
+
+        void endMessage()
+        {
+            const size_t len = m_Buff.size() - m_MsgStart - kHeaderSize;
+            m_Buff[m_MsgStart] = (uint8_t)(len & 0xFF);
+            m_Buff[m_MsgStart + 1] = (uint8_t)(len >> 8);
+        }
+
+        void put8(uint8_t v) { m_Buff.push_back(v); }
+        void put16(uint16_t v) { put8((uint8_t)v); put8((uint8_t)(v >> 8)); }
+        void put32(uint32_t v) { put16((uint16_t)v); put16((uint16_t)(v >> 16)); }
+
+        // Patch a u16 that was written earlier (e.g. a count that we didn't
+        // know when we wrote it).
+        size_t tell() const { return m_Buff.size(); }
+        void patch16(size_t at, uint16_t v) { m_Buff[at] = (uint8_t)v; m_Buff[at + 1] = (uint8_t)(v >> 8); }
+
+    private:
+        std::vector<uint8_t>& m_Buff;
+        size_t m_MsgStart;
+    };
+
+    // Reads little endian values out of a message payload.  Reading past the
+    // end returns 0 and marks the reader as bad, rather than crashing.
+    class Reader
+    {
+    public:
+        Reader(const uint8_t* pData, size_t len) : m_pData(pData), m_Len(len), m_Pos(0), m_bBad(false) {}
+
+        uint8_t get8() 
+        { 
+            if (m_Pos >= m_Len) { m_bBad = true; return 0; }
+            return m_pData[m_Pos++];
+        }
+        uint16_t get16() { uint16_t lo = get8(); return (uint16_t)(lo | (get8() << 8)); }
+        uint32_t get32() { uint32_t lo = get16(); return lo | ((uint32_t)get16() << 16); }
+
+        bool isBad() const { return m_bBad; }
+
+    private:
+        const uint8_t* m_pData;
+        size_t m_Len;
+        size_t m_Pos;
+        bool m_bBad;
+    };
+
+    // If buff (starting at offset) holds a complete message, returns its
+    // total size (header included) and fills in the type and payload.  
+    // Otherwise returns 0.
+    inline size_t peekMessage(const std::vector<uint8_t>& buff, size_t offset,
+                              MessageType& type, const uint8_t*& pPayload, size_t& payloadLen)
+    {
+        if (buff.size() - offset < kHeaderSize)
+            return 0;
+
+        payloadLen = (size_t)buff[offset] | ((size_t)buff[offset + 1] << 8);
+        if (buff.size() - offset < kHeaderSize + payloadLen)
+            return 0;
+
+        type = (MessageType)buff[offset + 2];
+        pPayload = buff.data() + offset + kHeaderSize;
+        return kHeaderSize + payloadLen;
+    }
+
+    // Positions go over the wire in centimeters (so up to 655m).
+    inline uint16_t toCm(float meters) 
+    { 
+        const float cm = meters * 100.f + 0.5f;
+        return (cm <= 0.f) ? 0 : ((cm >= 65535.f) ? 65535 : (uint16_t)cm);
+    }
+    inline float fromCm(uint16_t cm) { return (float)cm / 100.f; }
+}
@@ -0,0 +1,126 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The headless match server.  Usage:
+//    crashloyal_server [socket path] [-t numWorkers] [-isolate aihostPath]
+//                      [-budget tickMs matchSec]
+
+#include "MatchServer.h"
+
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <thread>
+
+static MatchServer* s_pServer = NULL;
+
+static void onSignal(int)
+{
+    if (s_pServer)
+        s_pServer->stop();
+}
+
+int main(int argc, char* args[])
+{
+    std::string socketPath = "/tmp/crashloyal.sock";
+    unsigned int numWorkers = 4;
+    std::string aiHostPath;
+    ControllerBudget::Settings budget;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(args[i], "-t") == 0) && (i + 1 < argc))
+        {
+            numWorkers = (unsigned int)atoi(args[++i]);
+        }
+        else if ((strcmp(args[i], "-isolate") == 0) && (i + 1 < argc))
+        {
+            aiHostPath = args[++i];
+        }
+        else if ((strcmp(args[i], "-budget") == 0) && (i + 2 < argc))
+        {
+            budget.m_TickBudgetSec = (float)atof(args[++i]) / 1000.f;
+            budget.m_MatchBudgetSec = (float)atof(args[++i]);
+        }
+        else
+        {
+            socketPath = args[i];
+        }
+    }
+
+    // Every match has at least one connection, so we need lots of fds.
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    MatchServer server(socketPath, numWorkers);
+    server.setAIHost(aiHostPath);
+    server.setControllerBudget(budget);
+    if (!server.start())
+        return 1;
+
+    s_pServer = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Listening on %s with %u workers\n", socketPath.c_str(), numWorkers);
+
+    // Report what's going on every few seconds.
+    std::thread reporter([&server]()
+    {
+        using namespace std::chrono;
+        MatchServer::Stats prev = server.getStats();
+        steady_clock::time_point prevTime = steady_clock::now();
+        while (s_pServer)
+        {
+            std::this_thread::sleep_for(milliseconds(100));
+            steady_clock::time_point now = steady_clock::now();
+            if (now - prevTime < seconds(5))
+                continue;
+
+            MatchServer::Stats stats = server.getStats();
+            const double secs = duration<double>(now - prevTime).count();
+            printf("matches: %llu active, %llu finished | %.0f ticks/sec | %.1f KB/sec\n",
+                   (unsigned long long)stats.m_MatchesActive,
+                   (unsigned long long)stats.m_MatchesFinished,
+                   (double)(stats.m_TicksSimulated - prev.m_TicksSimulated) / secs,
+                   (double)(stats.m_BytesSent - prev.m_BytesSent) / (1024. * secs));
+            fflush(stdout);
+
+            prev = stats;
+            prevTime = now;
+        }
+    });
+
+    server.run();
+
+    s_pServer = NULL;
+    reporter.join();
+    return 0;
+}
@@ -0,0 +1,144 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// The shared memory channel between Controller_Shm (in the game process) and
+// the aihost process that runs the real controller.  
+//
+// Each tick the game writes the world state into m_State (under a seqlock),
+// bumps m_Published and wakes the host.  The host copies the state out, 
+// ticks its controller, pushes any placements onto the command ring (tagged
+// with the tick they're for), then sets m_Done to that tick and wakes the 
+// game.  m_Published and m_Done are futex words, so neither side burns CPU
+// while it waits.
+//
+// The game never waits forever - if the host is too slow it moves on, and 
+// the seqlock lets it overwrite the state while a late host might still be 
+// reading it (the host just rereads).  Commands tagged with an old tick are
+// thrown away.
+// NOTE: This is Linux only (it uses futexes).
+
+#include <atomic>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Shm
+{
+    const uint32_t kMagic = 0x43534C32;     // 'CSL2'
+    const uint32_t kMaxEntities = 512;      // per list - anything past this is dropped
+    const uint32_t kCommandRingSize = 64;   // must be a power of two
+
+    // The aihost finds the channel on this fd.
+    const int kHostFd = 3;
+
+    enum EntityList
+    {
+        MyBuildings,
+        MyMobs,
+        TheirBuildings,
+        TheirMobs,
+
+        numEntityLists
+    };
+
+    struct EntityRecord
+    {
+        int32_t m_Type;         // MobType or BuildingType, depending on the list
+        int32_t m_Health;
+        float m_X;
+        float m_Y;
+    };
+
+    struct WorldState
+    {
+        uint32_t m_Tick;
+        float m_DeltaTSec;
+        float m_Elixir;
+        uint32_t m_bNorth;
+        int32_t m_ArenaWidth;   // see ArenaLayout
+        int32_t m_ArenaHeight;
+        uint32_t m_Counts[numEntityLists];
+        EntityRecord m_Entities[numEntityLists][kMaxEntities];
+    };
+
+    struct Command
+    {
+        uint32_t m_Tick;
+        int32_t m_MobType;
+        float m_X;
+        float m_Y;
+    };
+
+    // Each side's atomics get their own cache line, so that the two 
+    // processes don't fight over them.
+    struct Channel
+    {
+        uint32_t m_Magic;
+
+        alignas(64) std::atomic<uint32_t> m_Published;  // written by the game
+        std::atomic<uint32_t> m_StateSeq;               // odd while the game is writing m_State
+        std::atomic<uint32_t> m_CmdTail;                // commands the game has consumed
+
+        alignas(64) std::atomic<uint32_t> m_Done;       // written by the host
+        std::atomic<uint32_t> m_CmdHead;                // commands the host has pushed
+
+        alignas(64) Command m_Commands[kCommandRingSize];
+        WorldState m_State;
+    };
+
+    // Sleep until *pWord != expected, we're woken, or timeoutNs passes.
+    // These are shared (not FUTEX_PRIVATE) since the word lives in memory
+    // that's mapped into two processes.
+    inline void futexWait(std::atomic<uint32_t>* pWord, uint32_t expected, int64_t timeoutNs)
+    {
+        timespec ts;
+        ts.tv_sec = (time_t)(timeoutNs / 1000000000);
+        ts.tv_nsec = (long)(timeoutNs % 1000000000);
+        syscall(SYS_futex, (uint32_t*)pWord, FUTEX_WAIT, expected, &ts, NULL, 0);
+    }
+
+    inline void futexWake(std::atomic<uint32_t>* pWord)
+    {
+        syscall(SYS_futex, (uint32_t*)pWord, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+
+    // Spin for a little while before falling back to the futex, since the
+    // other side usually answers in a few microseconds.  Returns true if the
+    // word changed away from expected.
+    inline bool spinWhileEqual(const std::atomic<uint32_t>& word, uint32_t expected, unsigned int numSpins)
+    {
+        for (unsigned int i = 0; i < numSpins; ++i)
+        {
+            if (word.load(std::memory_order_acquire) != expected)
+                return true;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+        return word.load(std::memory_order_acquire) != expected;
+    }
+}
@@ -0,0 +1,186 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ShmPlayer.h"
+
+#include "Constants.h"
+
+#include <algorithm>
+#include <sched.h>
+
+ShmPlayer::ShmPlayer(Shm::Channel& channel)
+    : m_Channel(channel)
+    , m_pScratch(new Shm::WorldState)
+    , m_Tick(0)
+    , m_DeltaTSec(0.f)
+    , m_Elixir(0.f)
+    , m_bNorth(false)
+{
+    m_Influence[0] = InfluenceMap(m_Layout);
+    m_Influence[1] = InfluenceMap(m_Layout);
+
+    for (size_t i = 0; i < iEntityStats::numMobTypes; ++i)
+    {
+        m_AvailableMobs.push_back((iEntityStats::MobType)i);
+    }
+}
+
+uint32_t ShmPlayer::readState()
+{
+    const Shm::WorldState& shared = m_Channel.m_State;
+    Shm::WorldState& state = *m_pScratch;
+
+    // Seqlock read: copy everything out, and start over if the game wrote 
+    // to it while we were copying.  We only copy the entities that are in 
+    // use, and the counts might be torn, so clamp them.
+    while (true)
+    {
+        const uint32_t seq = m_Channel.m_StateSeq.load(std::memory_order_acquire);
+        if (seq & 1)
+        {
+            sched_yield();
+            continue;
+        }
+
+        memcpy(&state, &shared, offsetof(Shm::WorldState, m_Entities));
+        for (int list = 0; list < Shm::numEntityLists; ++list)
+        {
+            state.m_Counts[list] = std::min(state.m_Counts[list], Shm::kMaxEntities);
+            memcpy(state.m_Entities[list], shared.m_Entities[list], state.m_Counts[list] * sizeof(Shm::EntityRecord));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_Channel.m_StateSeq.load(std::memory_order_relaxed) == seq)
+            break;
+    }
+
+    m_Tick = state.m_Tick;
+    m_DeltaTSec = state.m_DeltaTSec;
+    m_Elixir = state.m_Elixir;
+    m_bNorth = (state.m_bNorth != 0);
+    m_PlacementResults.clear();
+    if ((state.m_ArenaWidth != m_Layout.getWidth()) || (state.m_ArenaHeight != m_Layout.getHeight()))
+    {
+        m_Layout = ArenaLayout(state.m_ArenaWidth, state.m_ArenaHeight);
+        m_Influence[0] = InfluenceMap(m_Layout);
+        m_Influence[1] = InfluenceMap(m_Layout);
+    }
+
+    for (int list = 0; list < Shm::numEntityLists; ++list)
+    {
+        const bool bBuildings = (list == Shm::MyBuildings) || (list == Shm::TheirBuildings);
+        std::vector<Entity>& entities = m_Entities[list];
+        entities.clear();
+
+        for (uint32_t i = 0; i < state.m_Counts[list]; ++i)
+        {
+            const Shm::EntityRecord& rec = state.m_Entities[list][i];
+            // Skip anything we don't recognize (e.g. from a newer game).
+            Entity e;
+            if (bBuildings)
+            {
+                if ((rec.m_Type < 0) || (rec.m_Type >= iEntityStats::numBuildingTypes))
+                    continue;
+                e.m_pStats = &iEntityStats::getBuildingStats((iEntityStats::BuildingType)rec.m_Type);
+            }
+            else
+            {
+                if ((rec.m_Type < 0) || (rec.m_Type >= iEntityStats::numMobTypes))
+                    continue;
+                e.m_pStats = &iEntityStats::getStats((iEntityStats::MobType)rec.m_Type);
+            }
+            e.m_Health = rec.m_Health;
+            e.m_Pos = Vec2(rec.m_X, rec.m_Y);
+            entities.push_back(e);
+        }
+    }
+
+    for (int side = 0; side < 2; ++side)
+    {
+        InfluenceMap& map = m_Influence[side];
+        map.clear();
+
+        InfluenceMap::Stamp stamp;
+        for (Shm::EntityList list : { side ? Shm::TheirBuildings : Shm::MyBuildings, side ? Shm::TheirMobs : Shm::MyMobs })
+        {
+            for (const Entity& e : m_Entities[list])
+            {
+                stamp = InfluenceMap::Stamp();
+                map.update(stamp, *e.m_pStats, e.m_Pos, e.m_Health);
+            }
+        }
+    }
+
+    return m_Tick;
+}
+
+iPlayer::EntityData ShmPlayer::get(Shm::EntityList list, unsigned int i) const
+{
+    const std::vector<Entity>& entities = m_Entities[list];
+    if (i < entities.size())
+    {
+        const Entity& e = entities[i];
+        return EntityData(*e.m_pStats, e.m_Health, e.m_Pos);
+    }
+
+    return EntityData();
+}
+
+iPlayer::PlacementResult ShmPlayer::placeMob(iEntityStats::MobType type, const Vec2& pos)
+{
+    // These are the same checks (in the same order) as Player::placeMob().
+    const Real tileX = Real((int)pos.x) + Real(0.5f);
+    const Real tileY = Real((int)pos.y) + Real(0.5f);
+    if (!m_Layout.isValidPlacementX(tileX))
+        return InvalidX;
+    if (!m_Layout.isValidPlacementY(tileY, m_bNorth))
+        return InvalidY;
+
+    if ((type < 0) || (type >= iEntityStats::numMobTypes))
+        return MobTypeUnavailable;
+
+    const float cost = iEntityStats::getStats(type).getElixirCost();
+    if (cost > m_Elixir)
+        return InsufficientElixir;
+
+    // If the game hasn't caught up with the ring then there's nowhere to put
+    // this.  That would take a lot of placements in one tick.
+    const uint32_t head = m_Channel.m_CmdHead.load(std::memory_order_relaxed);
+    if (head - m_Channel.m_CmdTail.load(std::memory_order_acquire) >= Shm::kCommandRingSize)
+        return MobTypeUnavailable;
+
+    Shm::Command& cmd = m_Channel.m_Commands[head & (Shm::kCommandRingSize - 1)];
+    cmd.m_Tick = m_Tick;
+    cmd.m_MobType = (int32_t)type;
+    cmd.m_X = (float)pos.x;
+    cmd.m_Y = (float)pos.y;
+    m_Channel.m_CmdHead.store(head + 1, std::memory_order_release);
+
+    m_Elixir -= cost;
+    return Success;
+}
+
+unsigned int ShmPlayer::queuePlacement(iEntityStats::MobType type, const Vec2& pos)
+{
+    m_PlacementResults.push_back(placeMob(type, pos));
+    return (unsigned int)(m_PlacementResults.size() - 1);
+}
@@ -0,0 +1,102 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "iPlayer.h"
+#include "ShmChannel.h"
+
+#include <stdint.h>
+#include <vector>
+
+// The iPlayer that a controller sees when it's running in the aihost.  It 
+// reads its state from a copy of the shared memory channel, and sends 
+// placements back over the channel's command ring.
+//
+// placeMob() can't wait for the game to answer, so it does the same checks
+// that the game will and returns what the game's answer will be (the game 
+// still has the final say).  queuePlacement() does the same, and puts its 
+// answer straight into getPlacementResults() (until the next readState()).
+class ShmPlayer : public iPlayer
+{
+public:
+    explicit ShmPlayer(Shm::Channel& channel);
+    virtual ~ShmPlayer() { delete m_pScratch; }
+
+    // Copy the latest state out of the channel, and return the tick that it
+    // is for.
+    uint32_t readState();
+    float getDeltaTSec() const { return m_DeltaTSec; }
+
+    virtual bool isNorth() const { return m_bNorth; }
+    virtual const ArenaLayout& getLayout() const { return m_Layout; }
+    virtual float getElixir() const { return m_Elixir; }
+    virtual const std::vector<iEntityStats::MobType>& GetAvailableMobTypes() const { return m_AvailableMobs; }
+    virtual PlacementResult placeMob(iEntityStats::MobType type, const Vec2& pos);
+    virtual unsigned int queuePlacement(iEntityStats::MobType type, const Vec2& pos);
+    virtual const std::vector<PlacementResult>& getPlacementResults() const { return m_PlacementResults; }
+
+    virtual unsigned int getNumBuildings() const { return numIn(Shm::MyBuildings); }
+    virtual EntityData getBuilding(unsigned int i) const { return get(Shm::MyBuildings, i); }
+    virtual unsigned int getNumMobs() const { return numIn(Shm::MyMobs); }
+    virtual EntityData getMob(unsigned int i) const { return get(Shm::MyMobs, i); }
+
+    virtual unsigned int getNumOpponentBuildings() const { return numIn(Shm::TheirBuildings); }
+    virtual EntityData getOpponentBuilding(unsigned int i) const { return get(Shm::TheirBuildings, i); }
+    virtual unsigned int getNumOpponentMobs() const { return numIn(Shm::TheirMobs); }
+    virtual EntityData getOpponentMob(unsigned int i) const { return get(Shm::TheirMobs, i); }
+
+    // These aren't sent, we add them up from the entities in readState().
+    virtual const InfluenceMap& getInfluence() const { return m_Influence[0]; }
+    virtual const InfluenceMap& getOpponentInfluence() const { return m_Influence[1]; }
+
+private:
+    struct Entity
+    {
+        const iEntityStats* m_pStats;
+        int m_Health;
+        Vec2 m_Pos;
+    };
+
+    unsigned int numIn(Shm::EntityList list) const { return (unsigned int)m_Entities[list].size(); }
+    EntityData get(Shm::EntityList list, unsigned int i) const;
+
+private:
+    Shm::Channel& m_Channel;
+    Shm::WorldState* m_pScratch;        // owned - too big for the stack
+
+    uint32_t m_Tick;
+    float m_DeltaTSec;
+    float m_Elixir;
+    bool m_bNorth;
+    ArenaLayout m_Layout;       // only the size is sent, the rest is derived from that
+
+    std::vector<iEntityStats::MobType> m_AvailableMobs;
+    std::vector<Entity> m_Entities[Shm::numEntityLists];
+    InfluenceMap m_Influence[2];        // ours, then theirs
+    std::vector<PlacementResult> m_PlacementResults;
+
+private:
+    // DELIBERATELY UNDEFINED
+    ShmPlayer(const ShmPlayer& rhs);
+    ShmPlayer& operator=(const ShmPlayer& rhs);
+};
@@ -0,0 +1,210 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs the same multi-tick state machine for a crowd of mobs two ways - as
+// Behaviors, which the BehaviorScheduler only resumes when they're due, and
+// as state that's polled for every mob, every tick - and times both.  
+// Usage:
+//    crashloyal_behaviorbench [numMobs] [numTicks] [waitScale]
+// waitScale stretches (or shrinks) every wait, to see where the two cross.
+
+#include "BehaviorScheduler.h"
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "Mob.h"
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const float ksDeltaTSec = 0.05f;
+
+// A sentry that stands guard for a while, looks around (faster) for a bit,
+// and then rests, over and over - a stand-in for something like the 
+// Rogue's hide/spring/recover, with waits that are mostly seconds long.
+class Sentry
+{
+public:
+    Sentry(unsigned int seed, float waitScale)
+        : m_Seed(seed * 2654435761u + 1)
+        , m_WaitScale(waitScale)
+        , m_State(Guard)
+        , m_NumSteps(0)
+    {}
+
+    // Does whatever the current state does, and returns the time to do 
+    // the next one.
+    float step(Mob& mob, float now)
+    {
+        ++m_NumSteps;
+        switch (m_State)
+        {
+        case Guard:
+            m_State = Look;
+            return now + randomSec(1.f, 4.f);
+        case Look:
+            mob.setSpeed(mob.getStats().getSpeed() * 2.f);
+            m_State = Rest;
+            return now + randomSec(0.25f, 0.75f);
+        case Rest:
+            mob.setSpeed(mob.getStats().getSpeed());
+            m_State = Guard;
+            return now + randomSec(0.5f, 2.f);
+        }
+        return now;
+    }
+
+    size_t getNumSteps() const { return m_NumSteps; }
+
+private:
+    float randomSec(float minSec, float maxSec)
+    {
+        m_Seed = m_Seed * 1664525u + 1013904223u;
+        return m_WaitScale * (minSec + (maxSec - minSec) * (float)(m_Seed >> 8) / (float)(1 << 24));
+    }
+
+    enum State { Guard, Look, Rest };
+
+    unsigned int m_Seed;
+    float m_WaitScale;
+    State m_State;
+    size_t m_NumSteps;
+};
+
+class SentryBehavior : public Behavior
+{
+public:
+    explicit SentryBehavior(Mob& mob)
+        : Behavior(mob)
+        , m_Sentry(mob.getId(), sWaitScale)
+    {}
+
+    // start() only passes the mob, so this comes from main().
+    static float sWaitScale;
+
+    virtual Wait resume(float now) { return Wait::until(m_Sentry.step(getMob(), now)); }
+
+    Sentry m_Sentry;
+};
+
+float SentryBehavior::sWaitScale = 1.f;
+
+// The polled version keeps the same state, plus when to step next.
+struct PolledSentry
+{
+    PolledSentry(Mob* pMob, float waitScale)
+        : m_pMob(pMob)
+        , m_Sentry(pMob->getId(), waitScale)
+        , m_NextTime(-1.f)
+    {}
+
+    Mob* m_pMob;
+    Sentry m_Sentry;
+    float m_NextTime;
+};
+
+int main(int argc, char* args[])
+{
+    const int numMobs = (argc > 1) ? atoi(args[1]) : 5000;
+    const int numTicks = (argc > 2) ? atoi(args[2]) : 2000;
+    const float waitScale = (argc > 3) ? (float)atof(args[3]) : 1.f;
+    SentryBehavior::sWaitScale = waitScale;
+
+    Game game(NULL, NULL, 1);
+    game.setLogging(false);
+    const ArenaLayout& layout = game.getLayout();
+
+    const iEntityStats& stats = iEntityStats::getStats(iEntityStats::Swordsman);
+    std::vector<Mob*> mobs;
+    for (int i = 0; i < numMobs; ++i)
+    {
+        const float x = (float)(i % layout.getWidth()) + 0.5f;
+        const float y = (float)(i / layout.getWidth() % layout.getHeight()) + 0.5f;
+        mobs.push_back(new Mob(game, stats, Vec2(x, y), (i % 2) == 0));
+    }
+
+    // Scheduled: a wheel and scheduler of our own, so that nothing else in 
+    // the Game runs.
+    TimingWheel timers(TICK_MIN);
+    BehaviorScheduler scheduler(timers);
+    std::vector<SentryBehavior*> behaviors;
+    for (Mob* pMob : mobs)
+    {
+        behaviors.push_back(scheduler.start<SentryBehavior>(*pMob));
+    }
+    const size_t numFrames = scheduler.getNumFrames();
+
+    std::vector<PolledSentry> polled;
+    for (Mob* pMob : mobs)
+    {
+        polled.push_back(PolledSentry(pMob, waitScale));
+    }
+
+    using namespace std::chrono;
+    double scheduledSec = 0.;
+    double polledSec = 0.;
+    size_t numResumed = 0;
+    float time = 0.f;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        time += ksDeltaTSec;
+
+        steady_clock::time_point start = steady_clock::now();
+        timers.advance(time);
+        scheduler.run(time);
+        scheduledSec += duration<double>(steady_clock::now() - start).count();
+        numResumed += scheduler.getNumResumed();
+
+        // The wheel fires once now is past the due time, so poll the same way.
+        start = steady_clock::now();
+        for (PolledSentry& sentry : polled)
+        {
+            if (time > sentry.m_NextTime)
+            {
+                sentry.m_NextTime = sentry.m_Sentry.step(*sentry.m_pMob, time);
+            }
+        }
+        polledSec += duration<double>(steady_clock::now() - start).count();
+    }
+
+    size_t scheduledSteps = 0;
+    size_t polledSteps = 0;
+    for (size_t i = 0; i < behaviors.size(); ++i)
+    {
+        scheduledSteps += behaviors[i]->m_Sentry.getNumSteps();
+        polledSteps += polled[i].m_Sentry.getNumSteps();
+    }
+
+    printf("%d mobs, %d ticks, waits x%.2f: %zu steps scheduled, %zu polled%s\n", numMobs, numTicks, 
+           waitScale, scheduledSteps, polledSteps, (scheduledSteps == polledSteps) ? "" : " (MISMATCH!)");
+    printf("  scheduled: %.4fms per tick, %.1f resumes per tick, %zu frames (%zu at the start)\n",
+           scheduledSec * 1e3 / numTicks, (double)numResumed / numTicks, scheduler.getNumFrames(), numFrames);
+    printf("  polled:    %.4fms per tick, %d checks per tick\n", polledSec * 1e3 / numTicks, numMobs);
+    printf("  scheduled is %.2fx the speed of polled\n", polledSec / std::max(scheduledSec, 1e-9));
+
+    for (Mob* pMob : mobs) delete pMob;
+    return (scheduledSteps == polledSteps) ? 0 : 1;
+}
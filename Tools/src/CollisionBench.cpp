@@ -0,0 +1,120 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Drops a clump of mobs on top of each other in the middle of the arena, and
+// times the CollisionSolver as it pushes them apart.  Usage:
+//    crashloyal_collisionbench [numMobs]
+
+#include "CollisionSolver.h"
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "Mob.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Stop once no pair overlaps by more than this (in meters).
+static const float ksSettledPenetration = 0.005f;
+static const int ksMaxTicks = 500;
+
+// The worst overlap between any two mobs (brute force, so it's slow, but 
+// it's not part of what we're timing).
+static float maxPenetration(const std::vector<Mob*>& mobs)
+{
+    float worst = 0.f;
+    for (size_t i = 0; i < mobs.size(); ++i)
+    {
+        const Vec2& a = mobs[i]->getPosition();
+        const float ra = mobs[i]->getStats().getSize() / 2.f;
+        for (size_t j = i + 1; j < mobs.size(); ++j)
+        {
+            const Vec2& b = mobs[j]->getPosition();
+            const float minDist = ra + mobs[j]->getStats().getSize() / 2.f;
+            const float dist = (float)a.dist(b);
+            worst = std::max(worst, minDist - dist);
+        }
+    }
+    return worst;
+}
+
+int main(int argc, char* args[])
+{
+    const int numMobs = (argc > 1) ? atoi(args[1]) : 1000;
+
+    Game game(NULL, NULL, 1);
+    game.setLogging(false);
+
+    // A tight, repeatable clump: a mix of mob types, scattered over a disc 
+    // that's far too small for them.
+    std::vector<Mob*> mobs;
+    unsigned int seed = 12345;
+    for (int i = 0; i < numMobs; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const float angle = (float)(seed >> 8) / (float)(1 << 24) * 6.2831853f;
+        seed = seed * 1664525u + 1013904223u;
+        const float radius = (float)(seed >> 8) / (float)(1 << 24) * 3.f;
+
+        const Vec2 pos(GAME_GRID_WIDTH / 2.f + radius * cosf(angle), GAME_GRID_HEIGHT / 2.f + radius * sinf(angle));
+        const iEntityStats& stats = iEntityStats::getStats((iEntityStats::MobType)(i % iEntityStats::numMobTypes));
+        mobs.push_back(new Mob(game, stats, pos, (i % 2) == 0));
+    }
+
+    printf("%d mobs, %u relaxation passes per tick\n", numMobs, CollisionSolver::ksNumIterations);
+    printf("  start: worst overlap %.3fm\n", maxPenetration(mobs));
+
+    using namespace std::chrono;
+    CollisionSolver solver(game.getLayout());
+    double totalSec = 0.;
+    double worstSec = 0.;
+    size_t maxPairs = 0;
+    int tick = 0;
+    float penetration = 0.f;
+    for (; tick < ksMaxTicks; ++tick)
+    {
+        const steady_clock::time_point start = steady_clock::now();
+        solver.solve(mobs);
+        const double sec = duration<double>(steady_clock::now() - start).count();
+
+        totalSec += sec;
+        worstSec = std::max(worstSec, sec);
+        maxPairs = std::max(maxPairs, solver.getNumPairs());
+
+        for (Mob* pMob : mobs) pMob->commit();
+
+        penetration = maxPenetration(mobs);
+        if ((tick < 5) || (tick % 10 == 9))
+            printf("  tick %3d: %6zu pairs, worst overlap %.3fm, %.3fms\n", tick + 1, solver.getNumPairs(), penetration, sec * 1e3);
+        if (penetration < ksSettledPenetration)
+            break;
+    }
+
+    printf("%s after %d ticks: worst overlap %.4fm\n", (penetration < ksSettledPenetration) ? "Settled" : "NOT settled", tick + 1, penetration);
+    printf("  solve: %.3fms avg, %.3fms worst, %zu pairs at most\n", totalSec * 1e3 / (tick + 1), worstSec * 1e3, maxPairs);
+
+    for (Mob* pMob : mobs) delete pMob;
+    return 0;
+}
@@ -0,0 +1,285 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Finds the first tick where two runs of the same match stop agreeing, and
+// which entity it was that went wrong (see Game::getStateHash()).  Usage:
+//    crashloyal_desynccheck [-threads A B] [-nudge T] <scenario>
+//        Plays the scenario twice side by side, with A and B threads (1 
+//        and 0 by default - 0 is one per hardware thread), and compares 
+//        the hashes after every tick.  -nudge T moves a mob in the second
+//        run by a millimeter at tick T, to check that we catch it.
+//    crashloyal_desynccheck -streams [-bisect] <a> <b>
+//        Compares two state streams (see StreamRecorder), e.g. recorded by
+//        two different builds.  Scans the recorded hashes for the first 
+//        tick that differs, then decodes that tick from both to find the
+//        entities that differ.  -bisect bisects the hashes instead, which 
+//        is quicker on very long streams but can miss a difference that 
+//        has cancelled out by the end (see checkStreams()).
+
+#include "Constants.h"
+#include "Entity.h"
+#include "Game.h"
+#include "Mob.h"
+#include "Player.h"
+#include "Scenario.h"
+#include "StateStream.h"
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static void printEntity(const char* label, const Entity* pEntity)
+{
+    if (!pEntity)
+    {
+        printf("    %s: (not there)\n", label);
+        return;
+    }
+
+    printf("    %s: %s %s at (%.6f, %.6f), health %d, hash %016llx\n", label, pEntity->isNorth() ? "north" : "south",
+           pEntity->getStats().getName(), (float)pEntity->getPosition().x, (float)pEntity->getPosition().y,
+           pEntity->getHealth(), (unsigned long long)pEntity->getStateHash());
+}
+
+static void gatherEntities(Game& game, std::map<unsigned int, const Entity*>& entities)
+{
+    for (bool bNorth : { true, false })
+    {
+        Player& player = game.getPlayer(bNorth);
+        for (const Entity* pEntity : player.getBuildings())
+            entities[pEntity->getId()] = pEntity;
+        for (const Entity* pEntity : player.getMobs())
+            entities[pEntity->getId()] = pEntity;
+    }
+}
+
+static int checkLive(const std::string& path, unsigned int threadsA, unsigned int threadsB, int nudgeTick)
+{
+    Scenario scenario;
+    if (!scenario.load(path))
+        return 1;
+
+    Game* pGames[2] = { scenario.createGame(threadsA), scenario.createGame(threadsB) };
+    pGames[0]->setLogging(false);
+    pGames[1]->setLogging(false);
+    printf("%s: %u threads vs %u threads\n", scenario.getName().c_str(), 
+           pGames[0]->getNumThreads(), pGames[1]->getNumThreads());
+
+    const int maxTicks = (int)(scenario.getDuration() / TICK_MIN + 0.5f);
+    int tick = 0;
+    int result = 0;
+    for (; (tick < maxTicks) && (Scenario::getWinner(*pGames[0]) == Scenario::NoWinner); ++tick)
+    {
+        pGames[0]->tick(TICK_MIN);
+        pGames[1]->tick(TICK_MIN);
+
+        // Entity hashes are refreshed at the end of the tick, so this shows
+        // up on the tick after.
+        if (tick == nudgeTick)
+        {
+            for (Entity* pEntity : pGames[1]->getPlayer(true).getMobs())
+            {
+                Mob* pMob = static_cast<Mob*>(pEntity);
+                pMob->setNextPosition(pMob->getPosition() + Vec2(0.001f, 0.f));
+                pMob->commit();
+                printf("  nudged %s %u at tick %d\n", pMob->getStats().getName(), pMob->getId(), tick);
+                break;
+            }
+        }
+
+        if (pGames[0]->getStateHash() == pGames[1]->getStateHash())
+            continue;
+
+        printf("  first difference at tick %d (%.2fs): %016llx vs %016llx\n", tick, pGames[0]->getTime(),
+               (unsigned long long)pGames[0]->getStateHash(), (unsigned long long)pGames[1]->getStateHash());
+
+        std::map<unsigned int, const Entity*> entities[2];
+        gatherEntities(*pGames[0], entities[0]);
+        gatherEntities(*pGames[1], entities[1]);
+        for (const auto& entry : entities[0])
+            entities[1].insert(std::make_pair(entry.first, (const Entity*)NULL));
+        for (const auto& entry : entities[1])
+        {
+            const auto found = entities[0].find(entry.first);
+            const Entity* pA = (found != entities[0].end()) ? found->second : NULL;
+            const Entity* pB = entry.second;
+            if (pA && pB && (pA->getStateHash() == pB->getStateHash()))
+                continue;
+
+            printf("  entity %u differs:\n", entry.first);
+            printEntity("A", pA);
+            printEntity("B", pB);
+        }
+        result = 1;
+        break;
+    }
+
+    if (result == 0)
+        printf("  no difference in %d ticks, final hash %016llx\n", tick, (unsigned long long)pGames[0]->getStateHash());
+
+    delete pGames[0];
+    delete pGames[1];
+    return result;
+}
+
+static void printStreamEntity(const char* label, const StreamEntity* pEntity)
+{
+    if (!pEntity)
+    {
+        printf("    %s: (not there)\n", label);
+        return;
+    }
+
+    printf("    %s: %s %s %u at (%.2f, %.2f), health %d\n", label, pEntity->m_bNorth ? "north" : "south",
+           pEntity->m_bBuilding ? "building" : "mob", pEntity->m_Type, pEntity->m_X / 100.f, pEntity->m_Y / 100.f,
+           pEntity->m_Health);
+}
+
+static int checkStreams(const std::string& pathA, const std::string& pathB, bool bBisect)
+{
+    StateStreamReader readers[2];
+    if (!readers[0].load(pathA) || !readers[1].load(pathB))
+        return 1;
+    if (!readers[0].hasHashes() || !readers[1].hasHashes())
+    {
+        printf("Both streams need to have been recorded with hashes.\n");
+        return 1;
+    }
+
+    const unsigned int numFrames = std::min(readers[0].getNumFrames(), readers[1].getNumFrames());
+    uint64_t hashes[2];
+    auto isSame = [&](unsigned int frame)
+    {
+        readers[0].getStateHash(frame, hashes[0]);
+        readers[1].getStateHash(frame, hashes[1]);
+        return hashes[0] == hashes[1];
+    };
+
+    // Runs that have diverged don't always stay that way.  The state hash
+    // is an XOR over the live entities, so a difference in a mob that then 
+    // dies on the same tick in both runs disappears again.  Reading the 
+    // hashes doesn't decode anything, so just look at every one.
+    unsigned int hi = numFrames;
+    if (!bBisect)
+    {
+        for (unsigned int frame = 0; frame < numFrames; ++frame)
+        {
+            if (!isSame(frame))
+            {
+                hi = frame;
+                break;
+            }
+        }
+    }
+    else if ((numFrames > 0) && !isSame(numFrames - 1))
+    {
+        // Assumes that the runs stay diverged once they have, so it can 
+        // report the wrong tick (or nothing at all) if they don't.
+        unsigned int lo = 0;
+        hi = numFrames - 1;                         // hi is known to differ
+        if (!isSame(0))
+            hi = 0;
+        while (hi - lo > 1)
+        {
+            const unsigned int mid = lo + (hi - lo) / 2;
+            if (isSame(mid))
+                lo = mid;
+            else
+                hi = mid;
+        }
+    }
+
+    if (hi == numFrames)
+    {
+        printf("No difference in %u ticks", numFrames);
+        if (readers[0].getNumFrames() != readers[1].getNumFrames())
+            printf(" (but one stream is %u ticks long and the other %u)", readers[0].getNumFrames(), readers[1].getNumFrames());
+        printf("\n");
+        return (readers[0].getNumFrames() == readers[1].getNumFrames()) ? 0 : 1;
+    }
+
+    isSame(hi);
+    readers[0].seek(hi);
+    readers[1].seek(hi);
+    printf("First difference at tick %u (%.2fs): %016llx vs %016llx\n", hi, readers[0].getTime(),
+           (unsigned long long)hashes[0], (unsigned long long)hashes[1]);
+
+    // Both lists are sorted by id.
+    const std::vector<StreamEntity>& a = readers[0].getEntities();
+    const std::vector<StreamEntity>& b = readers[1].getEntities();
+    int numDiffering = 0;
+    size_t i = 0, j = 0;
+    while ((i < a.size()) || (j < b.size()))
+    {
+        const StreamEntity* pA = ((i < a.size()) && ((j == b.size()) || (a[i].m_Id <= b[j].m_Id))) ? &a[i] : NULL;
+        const StreamEntity* pB = ((j < b.size()) && ((i == a.size()) || (b[j].m_Id <= a[i].m_Id))) ? &b[j] : NULL;
+        i += pA ? 1 : 0;
+        j += pB ? 1 : 0;
+        if (pA && pB && (*pA == *pB))
+            continue;
+
+        printf("  entity %u differs:\n", pA ? pA->m_Id : pB->m_Id);
+        printStreamEntity("A", pA);
+        printStreamEntity("B", pB);
+        ++numDiffering;
+    }
+
+    if (numDiffering == 0)
+        printf("  the difference is smaller than the stream records (a centimeter), or is in a target\n");
+    return 1;
+}
+
+int main(int argc, char* args[])
+{
+    unsigned int threadsA = 1, threadsB = 0;
+    int nudgeTick = -1;
+    std::vector<std::string> paths;
+    bool bStreams = false;
+    bool bBisect = false;
+    bool bBadArgs = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(args[i], "-streams")) bStreams = true;
+        else if (!strcmp(args[i], "-bisect")) bBisect = true;
+        else if (!strcmp(args[i], "-threads") && (i + 2 < argc))
+        {
+            threadsA = (unsigned int)atoi(args[++i]);
+            threadsB = (unsigned int)atoi(args[++i]);
+        }
+        else if (!strcmp(args[i], "-nudge") && (i + 1 < argc)) nudgeTick = atoi(args[++i]);
+        else if (args[i][0] != '-') paths.push_back(args[i]);
+        else bBadArgs = true;
+    }
+
+    if (bBadArgs || (paths.size() != (bStreams ? 2u : 1u)) || (bBisect && !bStreams))
+    {
+        printf("Usage: %s [-threads A B] [-nudge T] <scenario>\n", args[0]);
+        printf("       %s -streams [-bisect] <a> <b>\n", args[0]);
+        return 1;
+    }
+
+    return bStreams ? checkStreams(paths[0], paths[1], bBisect) : checkLive(paths[0], threadsA, threadsB, nudgeTick);
+}
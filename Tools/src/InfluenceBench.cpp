@@ -0,0 +1,154 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Walks a crowd of mobs up and down the arena, hurting (and replacing) a few
+// of them every tick, and times keeping an InfluenceMap up to date as they 
+// go against adding it all up again from scratch.  Usage:
+//    crashloyal_influencebench [numMobs] [numTicks] [percentMoving]
+// Only percentMoving (100 by default) of the mobs walk, the rest stand still
+// as though they were fighting.
+
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "InfluenceMap.h"
+#include "Mob.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const float ksDeltaTSec = 0.05f;
+static const float ksHitChance = 0.02f;         // per mob per tick
+static const int ksHitDamage = 40;
+
+static unsigned int s_Seed = 12345;
+static float randFloat()
+{
+    s_Seed = s_Seed * 1664525u + 1013904223u;
+    return (float)(s_Seed >> 8) / (float)(1 << 24);
+}
+
+static Mob* spawn(Game& game, int i)
+{
+    const ArenaLayout& layout = game.getLayout();
+    const bool bNorth = (i % 2) == 0;
+    const float x = randFloat() * (float)layout.getWidth();
+    const float y = randFloat() * (float)layout.getHeight();
+    const iEntityStats& stats = iEntityStats::getStats((iEntityStats::MobType)((i / 2) % iEntityStats::numMobTypes));
+    return new Mob(game, stats, Vec2(x, y), bNorth);
+}
+
+int main(int argc, char* args[])
+{
+    const int numMobs = (argc > 1) ? atoi(args[1]) : 1000;
+    const int numTicks = (argc > 2) ? atoi(args[2]) : 400;
+    const int percentMoving = (argc > 3) ? atoi(args[3]) : 100;
+
+    Game game(NULL, NULL, 1);
+    game.setLogging(false);
+    const ArenaLayout& layout = game.getLayout();
+
+    std::vector<Mob*> mobs;
+    for (int i = 0; i < numMobs; ++i)
+    {
+        mobs.push_back(spawn(game, i));
+    }
+
+    using namespace std::chrono;
+    InfluenceMap incremental(layout);
+    InfluenceMap full(layout);
+    InfluenceMap::Stamp scratch;
+    double incrementalSec = 0.;
+    double fullSec = 0.;
+    size_t numDeaths = 0;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        // Everyone heads for the far end at their own speed (drifting a 
+        // little sideways), and starts over once they get there.
+        for (size_t i = 0; i < mobs.size(); ++i)
+        {
+            Mob* pMob = mobs[i];
+            if (randFloat() < ksHitChance)
+            {
+                pMob->takeDamage(ksHitDamage);
+            }
+            if ((int)(i % 100) >= percentMoving)
+                continue;
+
+            const float dir = pMob->isNorth() ? 1.f : -1.f;
+            const Vec2& pos = pMob->getPosition();
+            float x = (float)pos.x + (randFloat() - 0.5f) * 0.1f;
+            float y = (float)pos.y + dir * pMob->getStats().getSpeed() * ksDeltaTSec;
+            x = std::min(std::max(x, 0.f), (float)layout.getWidth());
+            if (y < 0.f) y += (float)layout.getHeight();
+            if (y > (float)layout.getHeight()) y -= (float)layout.getHeight();
+            pMob->setNextPosition(Vec2(x, y));
+            pMob->commit();
+        }
+
+        steady_clock::time_point start = steady_clock::now();
+        for (Mob* pMob : mobs)
+        {
+            incremental.update(pMob->getInfluenceStamp(), pMob->getStats(), pMob->getPosition(), pMob->getHealth());
+        }
+        incrementalSec += duration<double>(steady_clock::now() - start).count();
+
+        start = steady_clock::now();
+        full.clear();
+        for (Mob* pMob : mobs)
+        {
+            scratch = InfluenceMap::Stamp();
+            full.update(scratch, pMob->getStats(), pMob->getPosition(), pMob->getHealth());
+        }
+        fullSec += duration<double>(steady_clock::now() - start).count();
+
+        if (incremental != full)
+        {
+            printf("MISMATCH on tick %d\n", tick + 1);
+            return 1;
+        }
+
+        // Replace the dead (whose stamps have already been taken out).
+        for (size_t i = 0; i < mobs.size(); ++i)
+        {
+            if (mobs[i]->isDead())
+            {
+                delete mobs[i];
+                mobs[i] = spawn(game, (int)i);
+                ++numDeaths;
+            }
+        }
+    }
+
+    printf("%d mobs (%d%% moving), %d ticks, %zu deaths, maps matched every tick\n", numMobs, percentMoving, numTicks, numDeaths);
+    printf("  incremental: %.3fms per tick, %.1fns per mob\n", 
+           incrementalSec * 1e3 / numTicks, incrementalSec * 1e9 / ((double)numTicks * numMobs));
+    printf("  full:        %.3fms per tick, %.1fns per mob\n", 
+           fullSec * 1e3 / numTicks, fullSec * 1e9 / ((double)numTicks * numMobs));
+    printf("  speedup:     %.1fx\n", fullSec / std::max(incrementalSec, 1e-9));
+
+    for (Mob* pMob : mobs) delete pMob;
+    return 0;
+}
@@ -0,0 +1,119 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Plays Controller_AI_MCTS against Controller_AI_KevinDill, headlessly, and
+// reports who won and how fast the search ran.  They swap sides every 
+// match.  Usage:
+//    crashloyal_mctsbench [-matches N] [-budget ms] [-threads T] [-horizon seconds] [-length seconds]
+
+#include "Constants.h"
+#include "Controller_AI_KevinDill.h"
+#include "Controller_AI_MCTS.h"
+#include "Entity.h"
+#include "Game.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Total health of a side's towers that are still standing.
+static int getTowerHealth(Player& player)
+{
+    int health = 0;
+    for (const Entity* pBuilding : player.getBuildings())
+    {
+        health += std::max(pBuilding->getHealth(), 0);
+    }
+    return health;
+}
+
+int main(int argc, char* args[])
+{
+    int numMatches = 4;
+    float lengthSec = 180.f;
+    Controller_AI_MCTS::Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(args[i], "-matches") && (i + 1 < argc)) numMatches = atoi(args[++i]);
+        else if (!strcmp(args[i], "-budget") && (i + 1 < argc)) settings.m_DecisionBudgetMs = (float)atof(args[++i]);
+        else if (!strcmp(args[i], "-threads") && (i + 1 < argc)) settings.m_NumThreads = (unsigned int)atoi(args[++i]);
+        else if (!strcmp(args[i], "-horizon") && (i + 1 < argc)) settings.m_HorizonSec = (float)atof(args[++i]);
+        else if (!strcmp(args[i], "-length") && (i + 1 < argc)) lengthSec = (float)atof(args[++i]);
+        else
+        {
+            printf("Usage: %s [-matches N] [-budget ms] [-threads T] [-horizon seconds] [-length seconds]\n", args[0]);
+            return 1;
+        }
+    }
+
+    printf("MCTS (%.1fms per decision, %u threads, %.0fs horizon) vs KevinDill\n",
+           settings.m_DecisionBudgetMs, settings.m_NumThreads, settings.m_HorizonSec);
+    printf("%5s %6s %8s %7s %10s %10s %10s %12s\n",
+           "match", "mcts", "winner", "time", "mcts hp", "other hp", "decisions", "playouts/s");
+
+    int numWins = 0, numLosses = 0;
+    unsigned long long totalPlayouts = 0;
+    double totalSearchSec = 0.;
+    for (int match = 0; match < numMatches; ++match)
+    {
+        const bool bMctsNorth = (match % 2) == 0;
+        settings.m_Seed = 12345 + match;
+        Controller_AI_MCTS* pMcts = new Controller_AI_MCTS(settings);
+        iController* pOther = new Controller_AI_KevinDill;
+        Game game(bMctsNorth ? pMcts : pOther, bMctsNorth ? pOther : pMcts, 1);
+        game.setLogging(false);
+
+        // MCTS searches in think(), so give it its budget between every two
+        // ticks (it returns straight away when it has nothing to search).
+        const std::chrono::steady_clock::duration thinkTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(settings.m_DecisionBudgetMs));
+        while ((game.getTime() < lengthSec) && (game.checkGameOver() == 0))
+        {
+            game.tick(TICK_MIN);
+            game.think(std::chrono::steady_clock::now() + thinkTime);
+        }
+
+        const int result = game.checkGameOver();
+        const char* winner = "none";
+        if (result != 0)
+        {
+            const bool bMctsWon = ((result > 0) == bMctsNorth);
+            winner = bMctsWon ? "mcts" : "other";
+            numWins += bMctsWon ? 1 : 0;
+            numLosses += bMctsWon ? 0 : 1;
+        }
+
+        const Controller_AI_MCTS::Stats& stats = pMcts->getStats();
+        totalPlayouts += stats.m_NumPlayouts;
+        totalSearchSec += stats.m_SearchSec;
+        printf("%5d %6s %8s %7.1f %10d %10d %10u %12.0f\n", match + 1, bMctsNorth ? "north" : "south", winner,
+               game.getTime(), getTowerHealth(game.getPlayer(bMctsNorth)), getTowerHealth(game.getPlayer(!bMctsNorth)),
+               stats.m_NumDecisions, pMcts->getPlayoutsPerSecond());
+    }
+
+    printf("MCTS won %d, lost %d, drew %d; %.0f playouts per second overall\n", numWins, numLosses,
+           numMatches - numWins - numLosses, totalSearchSec > 0. ? totalPlayouts / totalSearchSec : 0.);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Has a line of archers fire at a line of targets across the arena for a
+// while, and times the ProjectilePool as it keeps up with everything in the
+// air.  Usage:
+//    crashloyal_projectilebench [numArchers] [numTicks]
+
+#include "Constants.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "Mob.h"
+#include "ProjectilePool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const float ksDeltaTSec = 0.05f;
+static const int ksNumTargets = 16;
+
+int main(int argc, char* args[])
+{
+    const int numArchers = (argc > 1) ? atoi(args[1]) : 500;
+    const int numTicks = (argc > 2) ? atoi(args[2]) : 1000;
+
+    Game game(NULL, NULL, 1);
+    game.setLogging(false);
+    const ArenaLayout& layout = game.getLayout();
+
+    // The archers are spread along the north side of the river, shooting at
+    // targets spread along the south side, so flight times vary.  Their 
+    // first shots are staggered, like a real crowd's would be.
+    const iEntityStats& archerStats = iEntityStats::getStats(iEntityStats::Archer);
+    std::vector<Mob*> archers;
+    std::vector<float> nextShot;
+    unsigned int seed = 12345;
+    for (int i = 0; i < numArchers; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const float x = (float)(seed >> 8) / (float)(1 << 24) * (float)layout.getWidth();
+        archers.push_back(new Mob(game, archerStats, Vec2(x, layout.getRiverTopY() - 1.f), true));
+        nextShot.push_back((float)(seed & 0xff) / 256.f * archerStats.getAttackTime());
+    }
+
+    std::vector<Mob*> targets;
+    for (int i = 0; i < ksNumTargets; ++i)
+    {
+        const float x = ((float)i + 0.5f) / (float)ksNumTargets * (float)layout.getWidth();
+        targets.push_back(new Mob(game, iEntityStats::getStats(iEntityStats::Giant), Vec2(x, layout.getRiverBotY() + 2.f), false));
+    }
+
+    using namespace std::chrono;
+    ProjectilePool pool;
+    std::vector<DamageIntent> landed;
+    double launchSec = 0.;
+    double advanceSec = 0.;
+    double worstAdvanceSec = 0.;
+    size_t numLaunched = 0;
+    size_t numLanded = 0;
+    size_t numUpdates = 0;          // projectiles advanced, summed over ticks
+    size_t maxInFlight = 0;
+    float time = 0.f;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        time += ksDeltaTSec;
+
+        steady_clock::time_point start = steady_clock::now();
+        for (int i = 0; i < numArchers; ++i)
+        {
+            if (nextShot[i] <= time)
+            {
+                Mob* pTarget = targets[i % ksNumTargets];
+                const float dist = (float)archers[i]->getPosition().dist(pTarget->getPosition());
+                pool.launch(archers[i], pTarget, archerStats.getDamage(), dist / PROJECTILE_SPEED);
+                nextShot[i] += archerStats.getAttackTime();
+                ++numLaunched;
+            }
+        }
+        launchSec += duration<double>(steady_clock::now() - start).count();
+
+        maxInFlight = std::max(maxInFlight, pool.getNumProjectiles());
+        numUpdates += pool.getNumProjectiles();
+
+        landed.clear();
+        start = steady_clock::now();
+        pool.advance(ksDeltaTSec, landed);
+        const double sec = duration<double>(steady_clock::now() - start).count();
+        advanceSec += sec;
+        worstAdvanceSec = std::max(worstAdvanceSec, sec);
+        numLanded += landed.size();
+    }
+
+    printf("%d archers, %d ticks: %zu launched, %zu landed, %zu in the air at most (capacity %zu)\n", 
+           numArchers, numTicks, numLaunched, numLanded, maxInFlight, pool.getCapacity());
+    printf("  advance: %.4fms avg, %.4fms worst, %.2fns per projectile\n", 
+           advanceSec * 1e3 / numTicks, worstAdvanceSec * 1e3, advanceSec * 1e9 / std::max(numUpdates, (size_t)1));
+    printf("  launch:  %.2fns per projectile\n", launchSec * 1e9 / std::max(numLaunched, (size_t)1));
+
+    for (Mob* pMob : archers) delete pMob;
+    for (Mob* pMob : targets) delete pMob;
+    return 0;
+}
@@ -0,0 +1,155 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Plays every scenario (*.scenario) in a directory, headlessly and in name 
+// order, and reports how each one went (see Scenario.h for the format).  If
+// a scenario says who should win and they don't, or a scenario won't load,
+// it counts as a failure and the exit code is 1.  Usage:
+//    crashloyal_scenariorunner [-v] [-threads N] <directory or file>...
+//  -v prints the play-by-play (including any placements that failed).
+
+#include "Constants.h"
+#include "Entity.h"
+#include "Game.h"
+#include "Player.h"
+#include "Scenario.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const char* getWinnerName(Scenario::Winner winner)
+{
+    switch (winner)
+    {
+    case Scenario::North: return "north";
+    case Scenario::South: return "south";
+    case Scenario::NoWinner: return "none";
+    default: return "-";
+    }
+}
+
+// king/left/right, in the order Player::buildBuildings() makes them.
+static std::string getTowerHealth(Player& player)
+{
+    std::string result;
+    for (const Entity* pBuilding : player.getBuildings())
+    {
+        char buff[16];
+        snprintf(buff, sizeof(buff), "%s%d", result.empty() ? "" : "/", std::max(pBuilding->getHealth(), 0));
+        result += buff;
+    }
+    return result;
+}
+
+int main(int argc, char* args[])
+{
+    bool bVerbose = false;
+    unsigned int numThreads = 0;
+    std::vector<std::string> paths;
+    bool bBadArgs = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(args[i], "-v")) bVerbose = true;
+        else if (!strcmp(args[i], "-threads") && (i + 1 < argc)) numThreads = (unsigned int)atoi(args[++i]);
+        else if (args[i][0] != '-') paths.push_back(args[i]);
+        else bBadArgs = true;
+    }
+
+    if (bBadArgs || paths.empty())
+    {
+        printf("Usage: %s [-v] [-threads N] <directory or file>...\n", args[0]);
+        return 1;
+    }
+
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    for (const std::string& path : paths)
+    {
+        std::error_code error;
+        if (!fs::is_directory(path, error))
+        {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (const fs::directory_entry& entry : fs::directory_iterator(path, error))
+        {
+            if (entry.path().extension() == ".scenario")
+                found.push_back(entry.path().string());
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+    printf("%-24s %6s %6s %7s %9s %16s %16s %s\n", 
+           "scenario", "winner", "time", "ticks", "ms/tick", "north towers", "south towers", "result");
+
+    using namespace std::chrono;
+    int numFailed = 0;
+    for (const std::string& file : files)
+    {
+        Scenario scenario;
+        if (!scenario.load(file))
+        {
+            printf("%-24s %s\n", file.c_str(), "FAILED TO LOAD");
+            ++numFailed;
+            continue;
+        }
+
+        Game* pGame = scenario.createGame(numThreads);
+        pGame->setLogging(bVerbose);
+
+        const int maxTicks = (int)(scenario.getDuration() / TICK_MIN + 0.5f);
+        int tick = 0;
+        const steady_clock::time_point start = steady_clock::now();
+        for (; (tick < maxTicks) && (Scenario::getWinner(*pGame) == Scenario::NoWinner); ++tick)
+        {
+            pGame->tick(TICK_MIN);
+        }
+        const double sec = duration<double>(steady_clock::now() - start).count();
+
+        const Scenario::Winner winner = Scenario::getWinner(*pGame);
+        const char* result = "-";
+        if (scenario.getExpectedWinner() != Scenario::Unspecified)
+        {
+            const bool bPassed = (winner == scenario.getExpectedWinner());
+            result = bPassed ? "pass" : "FAIL";
+            numFailed += bPassed ? 0 : 1;
+        }
+
+        printf("%-24s %6s %6.1f %7d %9.3f %16s %16s %s\n", scenario.getName().c_str(), getWinnerName(winner),
+               pGame->getTime(), tick, tick ? sec * 1e3 / tick : 0., getTowerHealth(pGame->getPlayer(true)).c_str(),
+               getTowerHealth(pGame->getPlayer(false)).c_str(), result);
+
+        delete pGame;
+    }
+
+    printf("%zu scenarios, %d failed\n", files.size(), numFailed);
+    return (numFailed > 0) ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Plays a scenario (see Scenario.h) while recording a state stream (see 
+// StateStream.h), and reports how big the stream is.  Then it checks that
+// seeking around in the stream gives back exactly what was recorded, and 
+// times the seeks.  Usage:
+//    crashloyal_streamrecorder [-keyframe seconds] [-o file] <scenario>
+//  -o saves the stream.
+
+#include "Constants.h"
+#include "Game.h"
+#include "Scenario.h"
+#include "StateStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+int main(int argc, char* args[])
+{
+    float keyframeSec = 5.f;
+    std::string outPath;
+    std::string scenarioPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(args[i], "-keyframe") && (i + 1 < argc)) keyframeSec = (float)atof(args[++i]);
+        else if (!strcmp(args[i], "-o") && (i + 1 < argc)) outPath = args[++i];
+        else if ((args[i][0] != '-') && scenarioPath.empty()) scenarioPath = args[i];
+        else scenarioPath.clear(), i = argc;
+    }
+    if (scenarioPath.empty())
+    {
+        printf("Usage: %s [-keyframe seconds] [-o file] <scenario>\n", args[0]);
+        return 1;
+    }
+
+    Scenario scenario;
+    if (!scenario.load(scenarioPath))
+        return 1;
+
+    Game* pGame = scenario.createGame();
+    pGame->setLogging(false);
+
+    // Keep what we recorded, to check the reader against.
+    std::ostringstream out(std::ios::binary);
+    StateStreamWriter writer(out, pGame->getLayout(), keyframeSec);
+    std::vector<std::vector<StreamEntity> > recorded;
+
+    const int maxTicks = (int)(scenario.getDuration() / TICK_MIN + 0.5f);
+    for (int tick = 0; (tick < maxTicks) && (Scenario::getWinner(*pGame) == Scenario::NoWinner); ++tick)
+    {
+        pGame->tick(TICK_MIN);
+        writer.record(*pGame);
+        recorded.push_back(writer.getEntities());
+    }
+    const uint64_t finalHash = pGame->getStateHash();
+    delete pGame;
+
+    const std::string bytes = out.str();
+    const unsigned int numFrames = writer.getNumFrames();
+    const uint64_t deltaBytes = writer.getNumBytes() - writer.getKeyframeBytes();
+    printf("%s: %u ticks, %llu bytes (%.1f per tick)\n", scenario.getName().c_str(), numFrames,
+           (unsigned long long)writer.getNumBytes(), (double)writer.getNumBytes() / numFrames);
+    printf("  keyframes every %.1fs: %llu bytes, deltas: %.1f bytes per tick\n", keyframeSec,
+           (unsigned long long)writer.getKeyframeBytes(), (double)deltaBytes / numFrames);
+    printf("  final state hash %016llx\n", (unsigned long long)finalHash);
+
+    if (!outPath.empty())
+    {
+        std::ofstream file(outPath.c_str(), std::ios::binary);
+        file.write(bytes.data(), bytes.size());
+        if (!file)
+        {
+            printf("Couldn't write %s\n", outPath.c_str());
+            return 1;
+        }
+    }
+
+    StateStreamReader reader;
+    if (!reader.parse(std::vector<uint8_t>(bytes.begin(), bytes.end()), scenario.getName()))
+        return 1;
+
+    // Play it straight through, then jump around.
+    using namespace std::chrono;
+    int numBad = 0;
+    for (unsigned int frame = 0; frame < numFrames; ++frame)
+    {
+        if ((frame > 0) && !reader.next())
+            return 1;
+        numBad += (reader.getEntities() == recorded[frame]) ? 0 : 1;
+    }
+
+    const int ksNumSeeks = 1000;
+    unsigned int seed = 12345;
+    double worstSec = 0.;
+    const steady_clock::time_point start = steady_clock::now();
+    for (int i = 0; i < ksNumSeeks; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const unsigned int frame = (seed >> 8) % numFrames;
+        const steady_clock::time_point seekStart = steady_clock::now();
+        if (!reader.seek(frame))
+            return 1;
+        worstSec = std::max(worstSec, duration<double>(steady_clock::now() - seekStart).count());
+        numBad += (reader.getEntities() == recorded[frame]) ? 0 : 1;
+    }
+    const double sec = duration<double>(steady_clock::now() - start).count();
+
+    printf("  %d random seeks: %.1fus on average, %.1fus worst, %d mismatches\n", ksNumSeeks,
+           sec * 1e6 / ksNumSeeks, worstSec * 1e6, numBad);
+    return (numBad > 0) ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+// MIT License
+// 
+// Copyright(c) 2020 Kevin Dill
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Floods the arena with mobs, to see how the engine holds up at many times 
+// the usual number of units.  Every interval, both sides spawn a wave of 
+// each mob type at random spots on their half, and we report how long the
+// ticks took, how much memory we've used, and how many allocations the 
+// ticks made, as the population grows.  -arena runs it on a bigger (or 
+// smaller) arena than the standard one.  Usage:
+//    crashloyal_stresstest [-waves N] [-count M] [-interval seconds] [-threads T] [-seed S] [-arena W H]
+
+#include "ArenaLayout.h"
+#include "Constants.h"
+#include "Entity.h"
+#include "EntityStats.h"
+#include "Game.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+// Count every allocation the program makes.  We only report the ones made
+// while ticking.
+static std::atomic<unsigned long long> s_NumAllocs(0);
+static std::atomic<unsigned long long> s_AllocBytes(0);
+
+void* operator new(size_t size)
+{
+    ++s_NumAllocs;
+    s_AllocBytes += size;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static double getPeakRssMB()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.;       // KB on Linux
+}
+
+static unsigned int countLiveMobs(Game& game)
+{
+    unsigned int count = 0;
+    for (bool bNorth : { true, false })
+    {
+        for (const Entity* pMob : game.getPlayer(bNorth).getMobs())
+        {
+            if (!pMob->isDead())
+                ++count;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char* args[])
+{
+    int numWaves = 10;
+    int perType = 25;               // per side, per wave
+    float intervalSec = 2.f;
+    unsigned int numThreads = 0;
+    unsigned int seed = 12345;
+    ArenaLayout layout;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(args[i], "-waves") && (i + 1 < argc)) numWaves = atoi(args[++i]);
+        else if (!strcmp(args[i], "-count") && (i + 1 < argc)) perType = atoi(args[++i]);
+        else if (!strcmp(args[i], "-interval") && (i + 1 < argc)) intervalSec = (float)atof(args[++i]);
+        else if (!strcmp(args[i], "-threads") && (i + 1 < argc)) numThreads = (unsigned int)atoi(args[++i]);
+        else if (!strcmp(args[i], "-seed") && (i + 1 < argc)) seed = (unsigned int)atoi(args[++i]);
+        else if (!strcmp(args[i], "-arena") && (i + 2 < argc))
+        {
+            const int width = atoi(args[++i]);
+            const int height = atoi(args[++i]);
+            layout = ArenaLayout(std::max(2, width & ~1), std::max(8, height));
+        }
+        else
+        {
+            printf("Usage: %s [-waves N] [-count M] [-interval seconds] [-threads T] [-seed S] [-arena W H]\n", args[0]);
+            return 1;
+        }
+    }
+
+    Game game(NULL, NULL, numThreads, layout);
+    game.setLogging(false);
+    game.setStressMode(true);
+
+    const int ticksPerWave = std::max(1, (int)(intervalSec / TICK_MIN + 0.5f));
+    printf("%d waves of %d of each mob type per side, every %d ticks, %u threads, %dx%d arena\n",
+           numWaves, perType, ticksPerWave, game.getNumThreads(), layout.getWidth(), layout.getHeight());
+    printf("%5s %7s %10s %10s %12s %12s %10s\n", 
+           "wave", "mobs", "ms/tick", "worst ms", "allocs/tick", "bytes/tick", "peak MB");
+
+    using namespace std::chrono;
+    double totalSec = 0.;
+    int totalTicks = 0;
+
+    // One extra interval at the end, to see the full population tick.
+    for (int wave = 0; wave <= numWaves; ++wave)
+    {
+        if (wave < numWaves)
+        {
+            for (bool bNorth : { true, false })
+            {
+                const float minY = bNorth ? 0.5f : layout.getRiverBotY() + 0.5f;
+                const float maxY = bNorth ? layout.getRiverTopY() - 0.5f : layout.getHeight() - 0.5f;
+                for (size_t type = 0; type < iEntityStats::numMobTypes; ++type)
+                {
+                    for (int i = 0; i < perType; ++i)
+                    {
+                        seed = seed * 1664525u + 1013904223u;
+                        const float x = 0.5f + (float)(seed >> 8) / (float)(1 << 24) * (layout.getWidth() - 1.f);
+                        seed = seed * 1664525u + 1013904223u;
+                        const float y = minY + (float)(seed >> 8) / (float)(1 << 24) * (maxY - minY);
+                        game.getPlayer(bNorth).placeMob((iEntityStats::MobType)type, Vec2(x, y));
+                    }
+                }
+            }
+        }
+
+        const unsigned int numMobs = countLiveMobs(game);
+        const unsigned long long allocsBefore = s_NumAllocs;
+        const unsigned long long bytesBefore = s_AllocBytes;
+        double waveSec = 0.;
+        double worstSec = 0.;
+        for (int tick = 0; tick < ticksPerWave; ++tick)
+        {
+            const steady_clock::time_point start = steady_clock::now();
+            game.tick(TICK_MIN);
+            const double sec = duration<double>(steady_clock::now() - start).count();
+            waveSec += sec;
+            worstSec = std::max(worstSec, sec);
+        }
+        totalSec += waveSec;
+        totalTicks += ticksPerWave;
+
+        printf("%5d %7u %10.3f %10.3f %12.1f %12.0f %10.1f\n", wave + 1, numMobs,
+               waveSec * 1e3 / ticksPerWave, worstSec * 1e3,
+               (double)(s_NumAllocs - allocsBefore) / ticksPerWave,
+               (double)(s_AllocBytes - bytesBefore) / ticksPerWave,
+               getPeakRssMB());
+    }
+
+    printf("%d ticks, %.3fms per tick on average, %u mobs left alive\n", 
+           totalTicks, totalSec * 1e3 / totalTicks, countLiveMobs(game));
+    return 0;
+}